@@ -15,6 +15,9 @@ namespace datetime {
 	namespace {
 		//Namespace-private stuff goes here
 		unordered_map<string, pair<string, const time_zone*>> _cached_zones;
+		//The tzdb the cached zones are from, which they keep from being reclaimed
+		date::tzdb_pin _cached_db;
+		bool _abbrev_lookup = false;
 
 		using std::filesystem::exists;
 
@@ -82,17 +85,82 @@ namespace datetime {
 
 	}
 
-	pair<string, const time_zone*> translate_zone(string search);
+	pair<string, const time_zone*> translate_zone(const tzdb& db, string search);
 
 	pair<string, const time_zone*> get_zone(string search) {
-		string newsearch = to_upper(search);
-		if (!_cached_zones.contains(newsearch)) {
-			_cached_zones[newsearch] = translate_zone(newsearch);
-			if (_cached_zones[newsearch].second == nullptr) {
-				_cached_zones[newsearch] = {search, locate_zone(search)};
+		return get_zone(search, date::floor<seconds>(system_clock::now()));
+	}
+
+	pair<string, const time_zone*> get_zone(string search, time_point_seconds when) {
+		date::tzdb_pin db;
+		return get_zone(db, search, when);
+	}
+
+	pair<string, const time_zone*> get_zone(date::tzdb_pin& db, string search, time_point_seconds when) {
+		pair<string, const time_zone*> found = try_get_zone(db, search, when);
+		if (found.second == nullptr) {
+			throw std::runtime_error(search + " not found in timezone database");
+		}
+		return found;
+	}
+
+	pair<string, const time_zone*> try_get_zone(string search) noexcept {
+		return try_get_zone(search, date::floor<seconds>(system_clock::now()));
+	}
+
+	pair<string, const time_zone*> try_get_zone(string search, time_point_seconds when) noexcept {
+		date::tzdb_pin db;
+		return try_get_zone(db, search, when);
+	}
+
+	pair<string, const time_zone*> try_get_zone(date::tzdb_pin& db, string search, time_point_seconds when) noexcept {
+		try {
+			if (!db) {
+				db = date::tzdb_pin {date::tzdb_snapshot {}};
 			}
+			//Zones from a tzdb that has been replaced are gone once nothing pins it, so the cache only holds one tzdb's
+			if (!_cached_db || &*_cached_db != &*db) {
+				_cached_zones.clear();
+				_cached_db = db;
+			}
+			string newsearch = to_upper(search);
+			auto cached = _cached_zones.find(newsearch);
+			if (cached != _cached_zones.end()) {
+				return cached->second;
+			}
+			//Zone and link names resolve through the tzdb's case-insensitive index
+			zone_match found = db->find_zone(search, true);
+			pair<string, const time_zone*> result;
+			if (found.zone != nullptr) {
+				result = {*found.name, found.zone};
+			} else {
+				result = translate_zone(*db, newsearch);
+				if (result.second == nullptr) {
+					const time_zone* zone = nullptr;
+					db->try_locate_zone(search, zone);
+					result = {search, zone};
+				}
+			}
+			//Misses aren't cached: a stream of distinct bad names would grow the cache without bound,
+			//and rejecting one again only costs a lookup in the tzdb's hashed index
+			if (result.second != nullptr) {
+				_cached_zones[newsearch] = result;
+				return result;
+			}
+			if (_abbrev_lookup) {
+				//Any other abbreviation goes to the first zone tzdb::locate_abbrev finds using it at when
+				//Whether one does depends on when (CEST only exists in summer), so these aren't cached
+				for (const string& abbrev : {search, newsearch}) {
+					const time_zone* zone = db->locate_abbrev(abbrev, when);
+					if (zone != nullptr) {
+						return {abbrev, zone};
+					}
+				}
+			}
+			return result;
+		} catch (...) {
+			return {search, nullptr};
 		}
-		return _cached_zones[newsearch];
 	}
 
 	void clear_cache() {
@@ -104,6 +172,10 @@ namespace datetime {
 		_cached_zones.clear();
 	}
 
+	void set_abbrev_lookup(bool enabled) {
+		_abbrev_lookup = enabled;
+	}
+
 	void set_install_dir(string new_dir) {
 		std::filesystem::path new_path {new_dir};
 		if (!exists(new_path.parent_path())) {
@@ -998,218 +1070,218 @@ namespace datetime {
 		return out;
 	}
 
-	pair<string, const time_zone*> translate_zone(string search) {
-		if (search == "AFRICA/ADDIS_ABABA") return {"Africa/Addis_Ababa", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/ASMARA") return {"Africa/Asmara", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/ASMERA") return {"Africa/Asmera", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/BAMAKO") return {"Africa/Bamako", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/BANGUI") return {"Africa/Bangui", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/BANJUL") return {"Africa/Banjul", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/BLANTYRE") return {"Africa/Blantyre", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/BRAZZAVILLE") return {"Africa/Brazzaville", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/BUJUMBURA") return {"Africa/Bujumbura", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/CONAKRY") return {"Africa/Conakry", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/DAKAR") return {"Africa/Dakar", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/DAR_ES_SALAAM") return {"Africa/Dar_es_Salaam", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/DJIBOUTI") return {"Africa/Djibouti", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/DOUALA") return {"Africa/Douala", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/FREETOWN") return {"Africa/Freetown", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/GABORONE") return {"Africa/Gaborone", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/HARARE") return {"Africa/Harare", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/KAMPALA") return {"Africa/Kampala", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/KIGALI") return {"Africa/Kigali", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/KINSHASA") return {"Africa/Kinshasa", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/LIBREVILLE") return {"Africa/Libreville", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/LOME") return {"Africa/Lome", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/LUANDA") return {"Africa/Luanda", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/LUBUMBASHI") return {"Africa/Lubumbashi", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/LUSAKA") return {"Africa/Lusaka", locate_zone("Africa/Maputo")};
-		if (search == "AFRICA/MALABO") return {"Africa/Malabo", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/MASERU") return {"Africa/Maseru", locate_zone("Africa/Johannesburg")};
-		if (search == "AFRICA/MBABANE") return {"Africa/Mbabane", locate_zone("Africa/Johannesburg")};
-		if (search == "AFRICA/MOGADISHU") return {"Africa/Mogadishu", locate_zone("Africa/Nairobi")};
-		if (search == "AFRICA/NIAMEY") return {"Africa/Niamey", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/NOUAKCHOTT") return {"Africa/Nouakchott", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/OUAGADOUGOU") return {"Africa/Ouagadougou", locate_zone("Africa/Abidjan")};
-		if (search == "AFRICA/PORTO-NOVO") return {"Africa/Porto-Novo", locate_zone("Africa/Lagos")};
-		if (search == "AFRICA/TIMBUKTU") return {"Africa/Timbuktu", locate_zone("Africa/Abidjan")};
-		if (search == "AMERICA/ANGUILLA") return {"America/Anguilla", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ANTIGUA") return {"America/Antigua", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ARGENTINA/COMODRIVADAVIA") return {"America/Argentina/ComodRivadavia", locate_zone("America/Argentina/Catamarca")};
-		if (search == "AMERICA/ARUBA") return {"America/Aruba", locate_zone("America/Curacao")};
-		if (search == "AMERICA/ATKA") return {"America/Atka", locate_zone("America/Adak")};
-		if (search == "AMERICA/BUENOS_AIRES") return {"America/Buenos_Aires", locate_zone("America/Argentina/Buenos_Aires")};
-		if (search == "AMERICA/CATAMARCA") return {"America/Catamarca", locate_zone("America/Argentina/Catamarca")};
-		if (search == "AMERICA/CAYMAN") return {"America/Cayman", locate_zone("America/Panama")};
-		if (search == "AMERICA/CORAL_HARBOUR") return {"America/Coral_Harbour", locate_zone("America/Atikokan")};
-		if (search == "AMERICA/CORDOBA") return {"America/Cordoba", locate_zone("America/Argentina/Cordoba")};
-		if (search == "AMERICA/DOMINICA") return {"America/Dominica", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ENSENADA") return {"America/Ensenada", locate_zone("America/Tijuana")};
-		if (search == "AMERICA/FORT_WAYNE") return {"America/Fort_Wayne", locate_zone("America/Indiana/Indianapolis")};
-		if (search == "AMERICA/GRENADA") return {"America/Grenada", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/GUADELOUPE") return {"America/Guadeloupe", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/INDIANAPOLIS") return {"America/Indianapolis", locate_zone("America/Indiana/Indianapolis")};
-		if (search == "AMERICA/JUJUY") return {"America/Jujuy", locate_zone("America/Argentina/Jujuy")};
-		if (search == "AMERICA/KNOX_IN") return {"America/Knox_IN", locate_zone("America/Indiana/Knox")};
-		if (search == "AMERICA/KRALENDIJK") return {"America/Kralendijk", locate_zone("America/Curacao")};
-		if (search == "AMERICA/LOUISVILLE") return {"America/Louisville", locate_zone("America/Kentucky/Louisville")};
-		if (search == "AMERICA/LOWER_PRINCES") return {"America/Lower_Princes", locate_zone("America/Curacao")};
-		if (search == "AMERICA/MARIGOT") return {"America/Marigot", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/MENDOZA") return {"America/Mendoza", locate_zone("America/Argentina/Mendoza")};
-		if (search == "AMERICA/MONTREAL") return {"America/Montreal", locate_zone("America/Toronto")};
-		if (search == "AMERICA/MONTSERRAT") return {"America/Montserrat", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/PORTO_ACRE") return {"America/Porto_Acre", locate_zone("America/Rio_Branco")};
-		if (search == "AMERICA/ROSARIO") return {"America/Rosario", locate_zone("America/Argentina/Cordoba")};
-		if (search == "AMERICA/SANTA_ISABEL") return {"America/Santa_Isabel", locate_zone("America/Tijuana")};
-		if (search == "AMERICA/SHIPROCK") return {"America/Shiprock", locate_zone("America/Denver")};
-		if (search == "AMERICA/ST_BARTHELEMY") return {"America/St_Barthelemy", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ST_KITTS") return {"America/St_Kitts", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ST_LUCIA") return {"America/St_Lucia", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ST_THOMAS") return {"America/St_Thomas", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/ST_VINCENT") return {"America/St_Vincent", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/TORTOLA") return {"America/Tortola", locate_zone("America/Port_of_Spain")};
-		if (search == "AMERICA/VIRGIN") return {"America/Virgin", locate_zone("America/Port_of_Spain")};
-		if (search == "ANTARCTICA/MCMURDO") return {"Antarctica/McMurdo", locate_zone("Pacific/Auckland")};
-		if (search == "ANTARCTICA/SOUTH_POLE") return {"Antarctica/South_Pole", locate_zone("Pacific/Auckland")};
-		if (search == "ARCTIC/LONGYEARBYEN") return {"Arctic/Longyearbyen", locate_zone("Europe/Oslo")};
-		if (search == "ASIA/ADEN") return {"Asia/Aden", locate_zone("Asia/Riyadh")};
-		if (search == "ASIA/ASHKHABAD") return {"Asia/Ashkhabad", locate_zone("Asia/Ashgabat")};
-		if (search == "ASIA/BAHRAIN") return {"Asia/Bahrain", locate_zone("Asia/Qatar")};
-		if (search == "ASIA/CALCUTTA") return {"Asia/Calcutta", locate_zone("Asia/Kolkata")};
-		if (search == "ASIA/CHONGQING") return {"Asia/Chongqing", locate_zone("Asia/Shanghai")};
-		if (search == "ASIA/CHUNGKING") return {"Asia/Chungking", locate_zone("Asia/Shanghai")};
-		if (search == "ASIA/DACCA") return {"Asia/Dacca", locate_zone("Asia/Dhaka")};
-		if (search == "ASIA/HARBIN") return {"Asia/Harbin", locate_zone("Asia/Shanghai")};
-		if (search == "ASIA/ISTANBUL") return {"Asia/Istanbul", locate_zone("Europe/Istanbul")};
-		if (search == "ASIA/KASHGAR") return {"Asia/Kashgar", locate_zone("Asia/Urumqi")};
-		if (search == "ASIA/KATMANDU") return {"Asia/Katmandu", locate_zone("Asia/Kathmandu")};
-		if (search == "ASIA/KUWAIT") return {"Asia/Kuwait", locate_zone("Asia/Riyadh")};
-		if (search == "ASIA/MACAO") return {"Asia/Macao", locate_zone("Asia/Macau")};
-		if (search == "ASIA/MUSCAT") return {"Asia/Muscat", locate_zone("Asia/Dubai")};
-		if (search == "ASIA/PHNOM_PENH") return {"Asia/Phnom_Penh", locate_zone("Asia/Bangkok")};
-		if (search == "ASIA/RANGOON") return {"Asia/Rangoon", locate_zone("Asia/Yangon")};
-		if (search == "ASIA/SAIGON") return {"Asia/Saigon", locate_zone("Asia/Ho_Chi_Minh")};
-		if (search == "ASIA/TEL_AVIV") return {"Asia/Tel_Aviv", locate_zone("Asia/Jerusalem")};
-		if (search == "ASIA/THIMBU") return {"Asia/Thimbu", locate_zone("Asia/Thimphu")};
-		if (search == "ASIA/UJUNG_PANDANG") return {"Asia/Ujung_Pandang", locate_zone("Asia/Makassar")};
-		if (search == "ASIA/ULAN_BATOR") return {"Asia/Ulan_Bator", locate_zone("Asia/Ulaanbaatar")};
-		if (search == "ASIA/VIENTIANE") return {"Asia/Vientiane", locate_zone("Asia/Bangkok")};
-		if (search == "ATLANTIC/FAEROE") return {"Atlantic/Faeroe", locate_zone("Atlantic/Faroe")};
-		if (search == "ATLANTIC/JAN_MAYEN") return {"Atlantic/Jan_Mayen", locate_zone("Europe/Oslo")};
-		if (search == "ATLANTIC/ST_HELENA") return {"Atlantic/St_Helena", locate_zone("Africa/Abidjan")};
-		if (search == "AUSTRALIA/ACT") return {"Australia/ACT", locate_zone("Australia/Sydney")};
-		if (search == "AUSTRALIA/CANBERRA") return {"Australia/Canberra", locate_zone("Australia/Sydney")};
-		if (search == "AUSTRALIA/LHI") return {"Australia/LHI", locate_zone("Australia/Lord_Howe")};
-		if (search == "AUSTRALIA/NSW") return {"Australia/NSW", locate_zone("Australia/Sydney")};
-		if (search == "AUSTRALIA/NORTH") return {"Australia/North", locate_zone("Australia/Darwin")};
-		if (search == "AUSTRALIA/QUEENSLAND") return {"Australia/Queensland", locate_zone("Australia/Brisbane")};
-		if (search == "AUSTRALIA/SOUTH") return {"Australia/South", locate_zone("Australia/Adelaide")};
-		if (search == "AUSTRALIA/TASMANIA") return {"Australia/Tasmania", locate_zone("Australia/Hobart")};
-		if (search == "AUSTRALIA/VICTORIA") return {"Australia/Victoria", locate_zone("Australia/Melbourne")};
-		if (search == "AUSTRALIA/WEST") return {"Australia/West", locate_zone("Australia/Perth")};
-		if (search == "AUSTRALIA/YANCOWINNA") return {"Australia/Yancowinna", locate_zone("Australia/Broken_Hill")};
-		if (search == "BRAZIL/ACRE") return {"Brazil/Acre", locate_zone("America/Rio_Branco")};
-		if (search == "BRAZIL/DENORONHA") return {"Brazil/DeNoronha", locate_zone("America/Noronha")};
-		if (search == "BRAZIL/EAST") return {"Brazil/East", locate_zone("America/Sao_Paulo")};
-		if (search == "BRAZIL/WEST") return {"Brazil/West", locate_zone("America/Manaus")};
-		if (search == "CANADA/ATLANTIC") return {"Canada/Atlantic", locate_zone("America/Halifax")};
-		if (search == "CANADA/CENTRAL") return {"Canada/Central", locate_zone("America/Winnipeg")};
-		if (search == "CANADA/EASTERN") return {"Canada/Eastern", locate_zone("America/Toronto")};
-		if (search == "CANADA/MOUNTAIN") return {"Canada/Mountain", locate_zone("America/Edmonton")};
-		if (search == "CANADA/NEWFOUNDLAND") return {"Canada/Newfoundland", locate_zone("America/St_Johns")};
-		if (search == "CANADA/PACIFIC") return {"Canada/Pacific", locate_zone("America/Vancouver")};
-		if (search == "CANADA/SASKATCHEWAN") return {"Canada/Saskatchewan", locate_zone("America/Regina")};
-		if (search == "CANADA/YUKON") return {"Canada/Yukon", locate_zone("America/Whitehorse")};
-		if (search == "CHILE/CONTINENTAL") return {"Chile/Continental", locate_zone("America/Santiago")};
-		if (search == "CHILE/EASTERISLAND") return {"Chile/EasterIsland", locate_zone("Pacific/Easter")};
-		if (search == "CUBA") return {"Cuba", locate_zone("America/Havana")};
-		if (search == "EGYPT") return {"Egypt", locate_zone("Africa/Cairo")};
-		if (search == "EIRE") return {"Eire", locate_zone("Europe/Dublin")};
-		if (search == "ETC/GMT+0") return {"Etc/GMT+0", locate_zone("Etc/GMT")};
-		if (search == "ETC/GMT-0") return {"Etc/GMT-0", locate_zone("Etc/GMT")};
-		if (search == "ETC/GMT0") return {"Etc/GMT0", locate_zone("Etc/GMT")};
-		if (search == "ETC/GREENWICH") return {"Etc/Greenwich", locate_zone("Etc/GMT")};
-		if (search == "ETC/UCT") return {"Etc/UCT", locate_zone("Etc/UTC")};
-		if (search == "ETC/UNIVERSAL") return {"Etc/Universal", locate_zone("Etc/UTC")};
-		if (search == "ETC/ZULU") return {"Etc/Zulu", locate_zone("Etc/UTC")};
-		if (search == "EUROPE/BELFAST") return {"Europe/Belfast", locate_zone("Europe/London")};
-		if (search == "EUROPE/BRATISLAVA") return {"Europe/Bratislava", locate_zone("Europe/Prague")};
-		if (search == "EUROPE/BUSINGEN") return {"Europe/Busingen", locate_zone("Europe/Zurich")};
-		if (search == "EUROPE/GUERNSEY") return {"Europe/Guernsey", locate_zone("Europe/London")};
-		if (search == "EUROPE/ISLE_OF_MAN") return {"Europe/Isle_of_Man", locate_zone("Europe/London")};
-		if (search == "EUROPE/JERSEY") return {"Europe/Jersey", locate_zone("Europe/London")};
-		if (search == "EUROPE/LJUBLJANA") return {"Europe/Ljubljana", locate_zone("Europe/Belgrade")};
-		if (search == "EUROPE/MARIEHAMN") return {"Europe/Mariehamn", locate_zone("Europe/Helsinki")};
-		if (search == "EUROPE/NICOSIA") return {"Europe/Nicosia", locate_zone("Asia/Nicosia")};
-		if (search == "EUROPE/PODGORICA") return {"Europe/Podgorica", locate_zone("Europe/Belgrade")};
-		if (search == "EUROPE/SAN_MARINO") return {"Europe/San_Marino", locate_zone("Europe/Rome")};
-		if (search == "EUROPE/SARAJEVO") return {"Europe/Sarajevo", locate_zone("Europe/Belgrade")};
-		if (search == "EUROPE/SKOPJE") return {"Europe/Skopje", locate_zone("Europe/Belgrade")};
-		if (search == "EUROPE/TIRASPOL") return {"Europe/Tiraspol", locate_zone("Europe/Chisinau")};
-		if (search == "EUROPE/VADUZ") return {"Europe/Vaduz", locate_zone("Europe/Zurich")};
-		if (search == "EUROPE/VATICAN") return {"Europe/Vatican", locate_zone("Europe/Rome")};
-		if (search == "EUROPE/ZAGREB") return {"Europe/Zagreb", locate_zone("Europe/Belgrade")};
-		if (search == "GB") return {"GB", locate_zone("Europe/London")};
-		if (search == "GB-EIRE") return {"GB-Eire", locate_zone("Europe/London")};
-		if (search == "GMT") return {"GMT", locate_zone("Etc/GMT")};
-		if (search == "GMT+0") return {"GMT+0", locate_zone("Etc/GMT")};
-		if (search == "GMT-0") return {"GMT-0", locate_zone("Etc/GMT")};
-		if (search == "GMT0") return {"GMT0", locate_zone("Etc/GMT")};
-		if (search == "GREENWICH") return {"Greenwich", locate_zone("Etc/GMT")};
-		if (search == "HONGKONG") return {"Hongkong", locate_zone("Asia/Hong_Kong")};
-		if (search == "ICELAND") return {"Iceland", locate_zone("Atlantic/Reykjavik")};
-		if (search == "INDIAN/ANTANANARIVO") return {"Indian/Antananarivo", locate_zone("Africa/Nairobi")};
-		if (search == "INDIAN/COMORO") return {"Indian/Comoro", locate_zone("Africa/Nairobi")};
-		if (search == "INDIAN/MAYOTTE") return {"Indian/Mayotte", locate_zone("Africa/Nairobi")};
-		if (search == "IRAN") return {"Iran", locate_zone("Asia/Tehran")};
-		if (search == "ISRAEL") return {"Israel", locate_zone("Asia/Jerusalem")};
-		if (search == "JAMAICA") return {"Jamaica", locate_zone("America/Jamaica")};
-		if (search == "JAPAN") return {"Japan", locate_zone("Asia/Tokyo")};
-		if (search == "KWAJALEIN") return {"Kwajalein", locate_zone("Pacific/Kwajalein")};
-		if (search == "LIBYA") return {"Libya", locate_zone("Africa/Tripoli")};
-		if (search == "MEXICO/BAJANORTE") return {"Mexico/BajaNorte", locate_zone("America/Tijuana")};
-		if (search == "MEXICO/BAJASUR") return {"Mexico/BajaSur", locate_zone("America/Mazatlan")};
-		if (search == "MEXICO/GENERAL") return {"Mexico/General", locate_zone("America/Mexico_City")};
-		if (search == "NZ") return {"NZ", locate_zone("Pacific/Auckland")};
-		if (search == "NZ-CHAT") return {"NZ-CHAT", locate_zone("Pacific/Chatham")};
-		if (search == "NAVAJO") return {"Navajo", locate_zone("America/Denver")};
-		if (search == "PRC") return {"PRC", locate_zone("Asia/Shanghai")};
-		if (search == "PACIFIC/JOHNSTON") return {"Pacific/Johnston", locate_zone("Pacific/Honolulu")};
-		if (search == "PACIFIC/MIDWAY") return {"Pacific/Midway", locate_zone("Pacific/Pago_Pago")};
-		if (search == "PACIFIC/PONAPE") return {"Pacific/Ponape", locate_zone("Pacific/Pohnpei")};
-		if (search == "PACIFIC/SAIPAN") return {"Pacific/Saipan", locate_zone("Pacific/Guam")};
-		if (search == "PACIFIC/SAMOA") return {"Pacific/Samoa", locate_zone("Pacific/Pago_Pago")};
-		if (search == "PACIFIC/TRUK") return {"Pacific/Truk", locate_zone("Pacific/Chuuk")};
-		if (search == "PACIFIC/YAP") return {"Pacific/Yap", locate_zone("Pacific/Chuuk")};
-		if (search == "POLAND") return {"Poland", locate_zone("Europe/Warsaw")};
-		if (search == "PORTUGAL") return {"Portugal", locate_zone("Europe/Lisbon")};
-		if (search == "ROC") return {"ROC", locate_zone("Asia/Taipei")};
-		if (search == "ROK") return {"ROK", locate_zone("Asia/Seoul")};
-		if (search == "SINGAPORE") return {"Singapore", locate_zone("Asia/Singapore")};
-		if (search == "TURKEY") return {"Turkey", locate_zone("Europe/Istanbul")};
-		if (search == "UCT") return {"UCT", locate_zone("Etc/UTC")};
-		if (search == "US/ALASKA") return {"US/Alaska", locate_zone("America/Anchorage")};
-		if (search == "US/ALEUTIAN") return {"US/Aleutian", locate_zone("America/Adak")};
-		if (search == "US/ARIZONA") return {"US/Arizona", locate_zone("America/Phoenix")};
-		if (search == "US/CENTRAL") return {"US/Central", locate_zone("America/Chicago")};
-		if (search == "US/EAST-INDIANA") return {"US/East-Indiana", locate_zone("America/Indiana/Indianapolis")};
-		if (search == "US/EASTERN") return {"US/Eastern", locate_zone("America/New_York")};
-		if (search == "US/HAWAII") return {"US/Hawaii", locate_zone("Pacific/Honolulu")};
-		if (search == "US/INDIANA-STARKE") return {"US/Indiana-Starke", locate_zone("America/Indiana/Knox")};
-		if (search == "US/MICHIGAN") return {"US/Michigan", locate_zone("America/Detroit")};
-		if (search == "US/MOUNTAIN") return {"US/Mountain", locate_zone("America/Denver")};
-		if (search == "US/PACIFIC") return {"US/Pacific", locate_zone("America/Los_Angeles")};
-		if (search == "US/SAMOA") return {"US/Samoa", locate_zone("Pacific/Pago_Pago")};
-		if (search == "UTC") return {"UTC", locate_zone("Etc/UTC")};
-		if (search == "UNIVERSAL") return {"Universal", locate_zone("Etc/UTC")};
-		if (search == "W-SU") return {"W-SU", locate_zone("Europe/Moscow")};
-		if (search == "ZULU") return {"Zulu", locate_zone("Etc/UTC")};
-		if (search == "PST") return {"PST", locate_zone("America/Los_Angeles")};
-		if (search == "PDT") return {"PDT", locate_zone("America/Los_Angeles")};
-		if (search == "EDT") return {"EDT", locate_zone("America/New_York")};
-		if (search == "CST") return {"CST", locate_zone("America/Chicago")};
-		if (search == "CDT") return {"CDT", locate_zone("America/Chicago")};
-		if (search == "MDT") return {"MDT", locate_zone("America/Denver")};
+	pair<string, const time_zone*> translate_zone(const tzdb& db, string search) {
+		if (search == "AFRICA/ADDIS_ABABA") return {"Africa/Addis_Ababa", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/ASMARA") return {"Africa/Asmara", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/ASMERA") return {"Africa/Asmera", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/BAMAKO") return {"Africa/Bamako", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/BANGUI") return {"Africa/Bangui", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/BANJUL") return {"Africa/Banjul", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/BLANTYRE") return {"Africa/Blantyre", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/BRAZZAVILLE") return {"Africa/Brazzaville", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/BUJUMBURA") return {"Africa/Bujumbura", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/CONAKRY") return {"Africa/Conakry", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/DAKAR") return {"Africa/Dakar", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/DAR_ES_SALAAM") return {"Africa/Dar_es_Salaam", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/DJIBOUTI") return {"Africa/Djibouti", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/DOUALA") return {"Africa/Douala", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/FREETOWN") return {"Africa/Freetown", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/GABORONE") return {"Africa/Gaborone", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/HARARE") return {"Africa/Harare", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/KAMPALA") return {"Africa/Kampala", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/KIGALI") return {"Africa/Kigali", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/KINSHASA") return {"Africa/Kinshasa", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/LIBREVILLE") return {"Africa/Libreville", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/LOME") return {"Africa/Lome", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/LUANDA") return {"Africa/Luanda", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/LUBUMBASHI") return {"Africa/Lubumbashi", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/LUSAKA") return {"Africa/Lusaka", db.locate_zone("Africa/Maputo")};
+		if (search == "AFRICA/MALABO") return {"Africa/Malabo", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/MASERU") return {"Africa/Maseru", db.locate_zone("Africa/Johannesburg")};
+		if (search == "AFRICA/MBABANE") return {"Africa/Mbabane", db.locate_zone("Africa/Johannesburg")};
+		if (search == "AFRICA/MOGADISHU") return {"Africa/Mogadishu", db.locate_zone("Africa/Nairobi")};
+		if (search == "AFRICA/NIAMEY") return {"Africa/Niamey", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/NOUAKCHOTT") return {"Africa/Nouakchott", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/OUAGADOUGOU") return {"Africa/Ouagadougou", db.locate_zone("Africa/Abidjan")};
+		if (search == "AFRICA/PORTO-NOVO") return {"Africa/Porto-Novo", db.locate_zone("Africa/Lagos")};
+		if (search == "AFRICA/TIMBUKTU") return {"Africa/Timbuktu", db.locate_zone("Africa/Abidjan")};
+		if (search == "AMERICA/ANGUILLA") return {"America/Anguilla", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ANTIGUA") return {"America/Antigua", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ARGENTINA/COMODRIVADAVIA") return {"America/Argentina/ComodRivadavia", db.locate_zone("America/Argentina/Catamarca")};
+		if (search == "AMERICA/ARUBA") return {"America/Aruba", db.locate_zone("America/Curacao")};
+		if (search == "AMERICA/ATKA") return {"America/Atka", db.locate_zone("America/Adak")};
+		if (search == "AMERICA/BUENOS_AIRES") return {"America/Buenos_Aires", db.locate_zone("America/Argentina/Buenos_Aires")};
+		if (search == "AMERICA/CATAMARCA") return {"America/Catamarca", db.locate_zone("America/Argentina/Catamarca")};
+		if (search == "AMERICA/CAYMAN") return {"America/Cayman", db.locate_zone("America/Panama")};
+		if (search == "AMERICA/CORAL_HARBOUR") return {"America/Coral_Harbour", db.locate_zone("America/Atikokan")};
+		if (search == "AMERICA/CORDOBA") return {"America/Cordoba", db.locate_zone("America/Argentina/Cordoba")};
+		if (search == "AMERICA/DOMINICA") return {"America/Dominica", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ENSENADA") return {"America/Ensenada", db.locate_zone("America/Tijuana")};
+		if (search == "AMERICA/FORT_WAYNE") return {"America/Fort_Wayne", db.locate_zone("America/Indiana/Indianapolis")};
+		if (search == "AMERICA/GRENADA") return {"America/Grenada", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/GUADELOUPE") return {"America/Guadeloupe", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/INDIANAPOLIS") return {"America/Indianapolis", db.locate_zone("America/Indiana/Indianapolis")};
+		if (search == "AMERICA/JUJUY") return {"America/Jujuy", db.locate_zone("America/Argentina/Jujuy")};
+		if (search == "AMERICA/KNOX_IN") return {"America/Knox_IN", db.locate_zone("America/Indiana/Knox")};
+		if (search == "AMERICA/KRALENDIJK") return {"America/Kralendijk", db.locate_zone("America/Curacao")};
+		if (search == "AMERICA/LOUISVILLE") return {"America/Louisville", db.locate_zone("America/Kentucky/Louisville")};
+		if (search == "AMERICA/LOWER_PRINCES") return {"America/Lower_Princes", db.locate_zone("America/Curacao")};
+		if (search == "AMERICA/MARIGOT") return {"America/Marigot", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/MENDOZA") return {"America/Mendoza", db.locate_zone("America/Argentina/Mendoza")};
+		if (search == "AMERICA/MONTREAL") return {"America/Montreal", db.locate_zone("America/Toronto")};
+		if (search == "AMERICA/MONTSERRAT") return {"America/Montserrat", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/PORTO_ACRE") return {"America/Porto_Acre", db.locate_zone("America/Rio_Branco")};
+		if (search == "AMERICA/ROSARIO") return {"America/Rosario", db.locate_zone("America/Argentina/Cordoba")};
+		if (search == "AMERICA/SANTA_ISABEL") return {"America/Santa_Isabel", db.locate_zone("America/Tijuana")};
+		if (search == "AMERICA/SHIPROCK") return {"America/Shiprock", db.locate_zone("America/Denver")};
+		if (search == "AMERICA/ST_BARTHELEMY") return {"America/St_Barthelemy", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ST_KITTS") return {"America/St_Kitts", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ST_LUCIA") return {"America/St_Lucia", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ST_THOMAS") return {"America/St_Thomas", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/ST_VINCENT") return {"America/St_Vincent", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/TORTOLA") return {"America/Tortola", db.locate_zone("America/Port_of_Spain")};
+		if (search == "AMERICA/VIRGIN") return {"America/Virgin", db.locate_zone("America/Port_of_Spain")};
+		if (search == "ANTARCTICA/MCMURDO") return {"Antarctica/McMurdo", db.locate_zone("Pacific/Auckland")};
+		if (search == "ANTARCTICA/SOUTH_POLE") return {"Antarctica/South_Pole", db.locate_zone("Pacific/Auckland")};
+		if (search == "ARCTIC/LONGYEARBYEN") return {"Arctic/Longyearbyen", db.locate_zone("Europe/Oslo")};
+		if (search == "ASIA/ADEN") return {"Asia/Aden", db.locate_zone("Asia/Riyadh")};
+		if (search == "ASIA/ASHKHABAD") return {"Asia/Ashkhabad", db.locate_zone("Asia/Ashgabat")};
+		if (search == "ASIA/BAHRAIN") return {"Asia/Bahrain", db.locate_zone("Asia/Qatar")};
+		if (search == "ASIA/CALCUTTA") return {"Asia/Calcutta", db.locate_zone("Asia/Kolkata")};
+		if (search == "ASIA/CHONGQING") return {"Asia/Chongqing", db.locate_zone("Asia/Shanghai")};
+		if (search == "ASIA/CHUNGKING") return {"Asia/Chungking", db.locate_zone("Asia/Shanghai")};
+		if (search == "ASIA/DACCA") return {"Asia/Dacca", db.locate_zone("Asia/Dhaka")};
+		if (search == "ASIA/HARBIN") return {"Asia/Harbin", db.locate_zone("Asia/Shanghai")};
+		if (search == "ASIA/ISTANBUL") return {"Asia/Istanbul", db.locate_zone("Europe/Istanbul")};
+		if (search == "ASIA/KASHGAR") return {"Asia/Kashgar", db.locate_zone("Asia/Urumqi")};
+		if (search == "ASIA/KATMANDU") return {"Asia/Katmandu", db.locate_zone("Asia/Kathmandu")};
+		if (search == "ASIA/KUWAIT") return {"Asia/Kuwait", db.locate_zone("Asia/Riyadh")};
+		if (search == "ASIA/MACAO") return {"Asia/Macao", db.locate_zone("Asia/Macau")};
+		if (search == "ASIA/MUSCAT") return {"Asia/Muscat", db.locate_zone("Asia/Dubai")};
+		if (search == "ASIA/PHNOM_PENH") return {"Asia/Phnom_Penh", db.locate_zone("Asia/Bangkok")};
+		if (search == "ASIA/RANGOON") return {"Asia/Rangoon", db.locate_zone("Asia/Yangon")};
+		if (search == "ASIA/SAIGON") return {"Asia/Saigon", db.locate_zone("Asia/Ho_Chi_Minh")};
+		if (search == "ASIA/TEL_AVIV") return {"Asia/Tel_Aviv", db.locate_zone("Asia/Jerusalem")};
+		if (search == "ASIA/THIMBU") return {"Asia/Thimbu", db.locate_zone("Asia/Thimphu")};
+		if (search == "ASIA/UJUNG_PANDANG") return {"Asia/Ujung_Pandang", db.locate_zone("Asia/Makassar")};
+		if (search == "ASIA/ULAN_BATOR") return {"Asia/Ulan_Bator", db.locate_zone("Asia/Ulaanbaatar")};
+		if (search == "ASIA/VIENTIANE") return {"Asia/Vientiane", db.locate_zone("Asia/Bangkok")};
+		if (search == "ATLANTIC/FAEROE") return {"Atlantic/Faeroe", db.locate_zone("Atlantic/Faroe")};
+		if (search == "ATLANTIC/JAN_MAYEN") return {"Atlantic/Jan_Mayen", db.locate_zone("Europe/Oslo")};
+		if (search == "ATLANTIC/ST_HELENA") return {"Atlantic/St_Helena", db.locate_zone("Africa/Abidjan")};
+		if (search == "AUSTRALIA/ACT") return {"Australia/ACT", db.locate_zone("Australia/Sydney")};
+		if (search == "AUSTRALIA/CANBERRA") return {"Australia/Canberra", db.locate_zone("Australia/Sydney")};
+		if (search == "AUSTRALIA/LHI") return {"Australia/LHI", db.locate_zone("Australia/Lord_Howe")};
+		if (search == "AUSTRALIA/NSW") return {"Australia/NSW", db.locate_zone("Australia/Sydney")};
+		if (search == "AUSTRALIA/NORTH") return {"Australia/North", db.locate_zone("Australia/Darwin")};
+		if (search == "AUSTRALIA/QUEENSLAND") return {"Australia/Queensland", db.locate_zone("Australia/Brisbane")};
+		if (search == "AUSTRALIA/SOUTH") return {"Australia/South", db.locate_zone("Australia/Adelaide")};
+		if (search == "AUSTRALIA/TASMANIA") return {"Australia/Tasmania", db.locate_zone("Australia/Hobart")};
+		if (search == "AUSTRALIA/VICTORIA") return {"Australia/Victoria", db.locate_zone("Australia/Melbourne")};
+		if (search == "AUSTRALIA/WEST") return {"Australia/West", db.locate_zone("Australia/Perth")};
+		if (search == "AUSTRALIA/YANCOWINNA") return {"Australia/Yancowinna", db.locate_zone("Australia/Broken_Hill")};
+		if (search == "BRAZIL/ACRE") return {"Brazil/Acre", db.locate_zone("America/Rio_Branco")};
+		if (search == "BRAZIL/DENORONHA") return {"Brazil/DeNoronha", db.locate_zone("America/Noronha")};
+		if (search == "BRAZIL/EAST") return {"Brazil/East", db.locate_zone("America/Sao_Paulo")};
+		if (search == "BRAZIL/WEST") return {"Brazil/West", db.locate_zone("America/Manaus")};
+		if (search == "CANADA/ATLANTIC") return {"Canada/Atlantic", db.locate_zone("America/Halifax")};
+		if (search == "CANADA/CENTRAL") return {"Canada/Central", db.locate_zone("America/Winnipeg")};
+		if (search == "CANADA/EASTERN") return {"Canada/Eastern", db.locate_zone("America/Toronto")};
+		if (search == "CANADA/MOUNTAIN") return {"Canada/Mountain", db.locate_zone("America/Edmonton")};
+		if (search == "CANADA/NEWFOUNDLAND") return {"Canada/Newfoundland", db.locate_zone("America/St_Johns")};
+		if (search == "CANADA/PACIFIC") return {"Canada/Pacific", db.locate_zone("America/Vancouver")};
+		if (search == "CANADA/SASKATCHEWAN") return {"Canada/Saskatchewan", db.locate_zone("America/Regina")};
+		if (search == "CANADA/YUKON") return {"Canada/Yukon", db.locate_zone("America/Whitehorse")};
+		if (search == "CHILE/CONTINENTAL") return {"Chile/Continental", db.locate_zone("America/Santiago")};
+		if (search == "CHILE/EASTERISLAND") return {"Chile/EasterIsland", db.locate_zone("Pacific/Easter")};
+		if (search == "CUBA") return {"Cuba", db.locate_zone("America/Havana")};
+		if (search == "EGYPT") return {"Egypt", db.locate_zone("Africa/Cairo")};
+		if (search == "EIRE") return {"Eire", db.locate_zone("Europe/Dublin")};
+		if (search == "ETC/GMT+0") return {"Etc/GMT+0", db.locate_zone("Etc/GMT")};
+		if (search == "ETC/GMT-0") return {"Etc/GMT-0", db.locate_zone("Etc/GMT")};
+		if (search == "ETC/GMT0") return {"Etc/GMT0", db.locate_zone("Etc/GMT")};
+		if (search == "ETC/GREENWICH") return {"Etc/Greenwich", db.locate_zone("Etc/GMT")};
+		if (search == "ETC/UCT") return {"Etc/UCT", db.locate_zone("Etc/UTC")};
+		if (search == "ETC/UNIVERSAL") return {"Etc/Universal", db.locate_zone("Etc/UTC")};
+		if (search == "ETC/ZULU") return {"Etc/Zulu", db.locate_zone("Etc/UTC")};
+		if (search == "EUROPE/BELFAST") return {"Europe/Belfast", db.locate_zone("Europe/London")};
+		if (search == "EUROPE/BRATISLAVA") return {"Europe/Bratislava", db.locate_zone("Europe/Prague")};
+		if (search == "EUROPE/BUSINGEN") return {"Europe/Busingen", db.locate_zone("Europe/Zurich")};
+		if (search == "EUROPE/GUERNSEY") return {"Europe/Guernsey", db.locate_zone("Europe/London")};
+		if (search == "EUROPE/ISLE_OF_MAN") return {"Europe/Isle_of_Man", db.locate_zone("Europe/London")};
+		if (search == "EUROPE/JERSEY") return {"Europe/Jersey", db.locate_zone("Europe/London")};
+		if (search == "EUROPE/LJUBLJANA") return {"Europe/Ljubljana", db.locate_zone("Europe/Belgrade")};
+		if (search == "EUROPE/MARIEHAMN") return {"Europe/Mariehamn", db.locate_zone("Europe/Helsinki")};
+		if (search == "EUROPE/NICOSIA") return {"Europe/Nicosia", db.locate_zone("Asia/Nicosia")};
+		if (search == "EUROPE/PODGORICA") return {"Europe/Podgorica", db.locate_zone("Europe/Belgrade")};
+		if (search == "EUROPE/SAN_MARINO") return {"Europe/San_Marino", db.locate_zone("Europe/Rome")};
+		if (search == "EUROPE/SARAJEVO") return {"Europe/Sarajevo", db.locate_zone("Europe/Belgrade")};
+		if (search == "EUROPE/SKOPJE") return {"Europe/Skopje", db.locate_zone("Europe/Belgrade")};
+		if (search == "EUROPE/TIRASPOL") return {"Europe/Tiraspol", db.locate_zone("Europe/Chisinau")};
+		if (search == "EUROPE/VADUZ") return {"Europe/Vaduz", db.locate_zone("Europe/Zurich")};
+		if (search == "EUROPE/VATICAN") return {"Europe/Vatican", db.locate_zone("Europe/Rome")};
+		if (search == "EUROPE/ZAGREB") return {"Europe/Zagreb", db.locate_zone("Europe/Belgrade")};
+		if (search == "GB") return {"GB", db.locate_zone("Europe/London")};
+		if (search == "GB-EIRE") return {"GB-Eire", db.locate_zone("Europe/London")};
+		if (search == "GMT") return {"GMT", db.locate_zone("Etc/GMT")};
+		if (search == "GMT+0") return {"GMT+0", db.locate_zone("Etc/GMT")};
+		if (search == "GMT-0") return {"GMT-0", db.locate_zone("Etc/GMT")};
+		if (search == "GMT0") return {"GMT0", db.locate_zone("Etc/GMT")};
+		if (search == "GREENWICH") return {"Greenwich", db.locate_zone("Etc/GMT")};
+		if (search == "HONGKONG") return {"Hongkong", db.locate_zone("Asia/Hong_Kong")};
+		if (search == "ICELAND") return {"Iceland", db.locate_zone("Atlantic/Reykjavik")};
+		if (search == "INDIAN/ANTANANARIVO") return {"Indian/Antananarivo", db.locate_zone("Africa/Nairobi")};
+		if (search == "INDIAN/COMORO") return {"Indian/Comoro", db.locate_zone("Africa/Nairobi")};
+		if (search == "INDIAN/MAYOTTE") return {"Indian/Mayotte", db.locate_zone("Africa/Nairobi")};
+		if (search == "IRAN") return {"Iran", db.locate_zone("Asia/Tehran")};
+		if (search == "ISRAEL") return {"Israel", db.locate_zone("Asia/Jerusalem")};
+		if (search == "JAMAICA") return {"Jamaica", db.locate_zone("America/Jamaica")};
+		if (search == "JAPAN") return {"Japan", db.locate_zone("Asia/Tokyo")};
+		if (search == "KWAJALEIN") return {"Kwajalein", db.locate_zone("Pacific/Kwajalein")};
+		if (search == "LIBYA") return {"Libya", db.locate_zone("Africa/Tripoli")};
+		if (search == "MEXICO/BAJANORTE") return {"Mexico/BajaNorte", db.locate_zone("America/Tijuana")};
+		if (search == "MEXICO/BAJASUR") return {"Mexico/BajaSur", db.locate_zone("America/Mazatlan")};
+		if (search == "MEXICO/GENERAL") return {"Mexico/General", db.locate_zone("America/Mexico_City")};
+		if (search == "NZ") return {"NZ", db.locate_zone("Pacific/Auckland")};
+		if (search == "NZ-CHAT") return {"NZ-CHAT", db.locate_zone("Pacific/Chatham")};
+		if (search == "NAVAJO") return {"Navajo", db.locate_zone("America/Denver")};
+		if (search == "PRC") return {"PRC", db.locate_zone("Asia/Shanghai")};
+		if (search == "PACIFIC/JOHNSTON") return {"Pacific/Johnston", db.locate_zone("Pacific/Honolulu")};
+		if (search == "PACIFIC/MIDWAY") return {"Pacific/Midway", db.locate_zone("Pacific/Pago_Pago")};
+		if (search == "PACIFIC/PONAPE") return {"Pacific/Ponape", db.locate_zone("Pacific/Pohnpei")};
+		if (search == "PACIFIC/SAIPAN") return {"Pacific/Saipan", db.locate_zone("Pacific/Guam")};
+		if (search == "PACIFIC/SAMOA") return {"Pacific/Samoa", db.locate_zone("Pacific/Pago_Pago")};
+		if (search == "PACIFIC/TRUK") return {"Pacific/Truk", db.locate_zone("Pacific/Chuuk")};
+		if (search == "PACIFIC/YAP") return {"Pacific/Yap", db.locate_zone("Pacific/Chuuk")};
+		if (search == "POLAND") return {"Poland", db.locate_zone("Europe/Warsaw")};
+		if (search == "PORTUGAL") return {"Portugal", db.locate_zone("Europe/Lisbon")};
+		if (search == "ROC") return {"ROC", db.locate_zone("Asia/Taipei")};
+		if (search == "ROK") return {"ROK", db.locate_zone("Asia/Seoul")};
+		if (search == "SINGAPORE") return {"Singapore", db.locate_zone("Asia/Singapore")};
+		if (search == "TURKEY") return {"Turkey", db.locate_zone("Europe/Istanbul")};
+		if (search == "UCT") return {"UCT", db.locate_zone("Etc/UTC")};
+		if (search == "US/ALASKA") return {"US/Alaska", db.locate_zone("America/Anchorage")};
+		if (search == "US/ALEUTIAN") return {"US/Aleutian", db.locate_zone("America/Adak")};
+		if (search == "US/ARIZONA") return {"US/Arizona", db.locate_zone("America/Phoenix")};
+		if (search == "US/CENTRAL") return {"US/Central", db.locate_zone("America/Chicago")};
+		if (search == "US/EAST-INDIANA") return {"US/East-Indiana", db.locate_zone("America/Indiana/Indianapolis")};
+		if (search == "US/EASTERN") return {"US/Eastern", db.locate_zone("America/New_York")};
+		if (search == "US/HAWAII") return {"US/Hawaii", db.locate_zone("Pacific/Honolulu")};
+		if (search == "US/INDIANA-STARKE") return {"US/Indiana-Starke", db.locate_zone("America/Indiana/Knox")};
+		if (search == "US/MICHIGAN") return {"US/Michigan", db.locate_zone("America/Detroit")};
+		if (search == "US/MOUNTAIN") return {"US/Mountain", db.locate_zone("America/Denver")};
+		if (search == "US/PACIFIC") return {"US/Pacific", db.locate_zone("America/Los_Angeles")};
+		if (search == "US/SAMOA") return {"US/Samoa", db.locate_zone("Pacific/Pago_Pago")};
+		if (search == "UTC") return {"UTC", db.locate_zone("Etc/UTC")};
+		if (search == "UNIVERSAL") return {"Universal", db.locate_zone("Etc/UTC")};
+		if (search == "W-SU") return {"W-SU", db.locate_zone("Europe/Moscow")};
+		if (search == "ZULU") return {"Zulu", db.locate_zone("Etc/UTC")};
+		if (search == "PST") return {"PST", db.locate_zone("America/Los_Angeles")};
+		if (search == "PDT") return {"PDT", db.locate_zone("America/Los_Angeles")};
+		if (search == "EDT") return {"EDT", db.locate_zone("America/New_York")};
+		if (search == "CST") return {"CST", db.locate_zone("America/Chicago")};
+		if (search == "CDT") return {"CDT", db.locate_zone("America/Chicago")};
+		if (search == "MDT") return {"MDT", db.locate_zone("America/Denver")};
 		return {search, nullptr};
 	}
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ Compile with arith_parse_strings defined to arithmetically parse date and time s
 #include <string>
 #include <filesystem>
 #include <deque>
+#include <new>
 
 /*
 Include local copies of the source for date.h and tz.h for 2 reasons:
@@ -41,6 +42,12 @@ Automatic timezone database updates require curl installed.  To install curl (on
 	-for static libraries-
 	7. vcpkg install curl[tool]:x86-windows-static curl[tool]:x64-windows-static
 
+To run without a tzdata folder on disk (read-only containers, no network), build with an embedded database:
+	1. Compile tools\embed_tzdata.cpp into its own executable
+	2. Run it as a pre-build step: embed_tzdata.exe timezones tzdata_embedded.cpp
+	3. Add the generated tzdata_embedded.cpp to the project
+	4. Define EMBEDDED_TZDB=1 and remove AUTO_DOWNLOAD=1 from the preprocessor definitions
+
 To use static curl libraries, 2 additional steps must be performed (on windows):
 	1. Use the x86-windows-static or x64-windows-static vcpkg triplet
 		- In visual studio, add these lines to the "Globals" property group in your .vcxproj file:
@@ -79,8 +86,21 @@ namespace datetime {
 	using date::current_zone;
 
 	std::pair<std::string, const time_zone*> get_zone(std::string search);
+	//when is the instant the zone is for, which decides what an abbreviation resolves to (see set_abbrev_lookup)
+	std::pair<std::string, const time_zone*> get_zone(std::string search, time_point_seconds when);
+	//Same as get_zone, but gives a null zone for a name that can't be resolved instead of throwing
+	std::pair<std::string, const time_zone*> try_get_zone(std::string search) noexcept;
+	std::pair<std::string, const time_zone*> try_get_zone(std::string search, time_point_seconds when) noexcept;
+	//These resolve in the tzdb db pins, pinning the newest one first if db is empty, so the zone stays valid for as long as db does
+	//The zones the ones above give stay valid until a lookup is done in another tzdb, as after a refresh
+	std::pair<std::string, const time_zone*> get_zone(date::tzdb_pin& db, std::string search, time_point_seconds when);
+	std::pair<std::string, const time_zone*> try_get_zone(date::tzdb_pin& db, std::string search, time_point_seconds when) noexcept;
 	void clear_cache();
 	void set_install_dir(std::string new_dir);
+	//Lets get_zone fall back to the zone that uses an abbreviation like CEST or PDT at the instant given
+	//(now if none is), so a DateTime set to CEST must fall in summer
+	//Off by default: the first lookup that falls back has to walk every zone in the database
+	void set_abbrev_lookup(bool enabled);
 	//With these parse functions, I considered writing a function to read a string and spit out a datetime, but it would be a whole ton of work to process it in a flexible manner
 	//I'm settling on letting the user worry about splitting out a string for the date and a separate string for the time and using these functions to parse them separately and add them into a datetime
 	sys_days parse_date(std::string instr, std::deque<std::string> fmts = {"%m/%d/%y", "%d%B%y", "%B %d, %y", "%A, %d %B, %y", "%A, %B %d, %y", "%d/%m/%y", "%B %d %y", "%d/%m/%y", "%d %B, %y", "%d %B %y", "%m/%d/%Y", "%d%B%Y", "%B %d, %Y", "%A, %d %B, %Y", "%A, %B %d, %Y", "%d/%m/%Y", "%B %d %Y", "%d/%m/%Y", "%d %B, %Y", "%d %B %Y"});
@@ -92,6 +112,8 @@ namespace datetime {
 	constexpr char h24_format [] = "%A %B %d, %Y %H:%M:%S";
 
 	static const time_zone* default_zone = nullptr;
+	//The tzdb default_zone is from, kept from being reclaimed while it's the default
+	static date::tzdb_pin default_zone_db;
 
 	class hour {
 	private:
@@ -213,26 +235,48 @@ namespace datetime {
 		time_point* _time_point;
 		const time_zone* _tz;
 		std::string _tz_name;
-		void _string_constructor_proxy(time_point* tp, std::string tz) {
+		//Keeps _tz from being reclaimed once a newer tzdb is published, unless _tz was passed in
+		date::tzdb_pin _db;
+		void _string_constructor_proxy(time_point* tp, std::string tz, bool nothrow = false) {
 			const time_zone* zone = default_zone;
+			date::tzdb_pin db = default_zone_db;
 			std::string zone_name {""};
 			if (tz != "") {
-				std::tie(zone_name, zone) = get_zone(tz);
+				time_point_seconds when = date::floor<seconds>(*tp);
+				db = date::tzdb_pin {};
+				std::tie(zone_name, zone) = nothrow ? try_get_zone(db, tz, when) : get_zone(db, tz, when);
 			} else {
 				if (zone == nullptr) {
+#if EMBEDDED_TZDB
+					//The database is compiled in, so there is no install folder to check
+					try {
+						date::tzdb_pin newest {date::tzdb_snapshot {}};
+						default_zone = newest->current_zone();
+						default_zone_db = newest;
+						zone = default_zone;
+						db = newest;
+					} catch (std::runtime_error) {
+						zone = nullptr;
+					}
+#else
 					std::string dir = date::get_install();
 					if (std::filesystem::exists(dir)) {
 						try {
 							date::get_version(dir + "\\");
-							default_zone = current_zone();
+							date::tzdb_pin newest {date::tzdb_snapshot {}};
+							default_zone = newest->current_zone();
+							default_zone_db = newest;
 							zone = default_zone;
+							db = newest;
 						} catch (std::runtime_error) {
 							zone = nullptr;
 						}
 					}
+#endif
 				}
 			}
 			_constructor_proxy(tp, zone, zone_name);
+			_db = db;
 		}
 		void _constructor_proxy(time_point* tp, const time_zone* zone, std::string zone_name = "") {
 			_time_point = tp;
@@ -253,6 +297,7 @@ namespace datetime {
 			_time_point = new time_point(*(other._time_point));
 			_tz = other._tz;
 			_tz_name = other._tz_name;
+			_db = other._db;
 			format = other.format;
 		}
 		DateTime(std::string zone = "") {
@@ -271,6 +316,17 @@ namespace datetime {
 		DateTime(const time_point_seconds& timeval, std::string zone = "") {
 			_string_constructor_proxy(new system_time_point(timeval), zone);
 		}
+		//These leave the timezone null when the zone name can't be resolved instead of throwing
+		DateTime(std::string zone, std::nothrow_t) {
+			_string_constructor_proxy(new system_time_point(), zone, true);
+		}
+		DateTime(const sys_days& timeval, std::string zone, std::nothrow_t) {
+			_string_constructor_proxy(new system_time_point(timeval), zone, true);
+		}
+		DateTime(const time_point_seconds& timeval, std::string zone, std::nothrow_t) {
+			_string_constructor_proxy(new system_time_point(timeval), zone, true);
+		}
+		//The caller has to keep zone valid, as with set_timezone
 		DateTime(const time_zone* zone) {
 			_constructor_proxy(new system_time_point(), zone);
 		}
@@ -294,7 +350,7 @@ namespace datetime {
 			if (_tz == nullptr) {
 				return date_type {date::floor<days>(*_time_point)};
 			}
-			return date_type {date::floor<days>(GetZonedTime().get_local_time())};
+			return date_type {date::floor<days>(_tz->to_local(*_time_point))};
 		}
 		_Duration GetTime() const {
 			return *_time_point - date::floor<days>(*_time_point);
@@ -305,7 +361,7 @@ namespace datetime {
 			if (_tz == nullptr) {
 				local_tp = date::clock_cast<date::local_t>(*_time_point);
 			} else {
-				local_tp = GetZonedTime().get_local_time();
+				local_tp = _tz->to_local(*_time_point);
 			}
 			return time_of_day<_out_Duration>(date::floor<_out_Duration>(local_tp - date::floor<days>(local_tp)));
 		}
@@ -467,11 +523,27 @@ namespace datetime {
 			return out;
 		}
 		void set_timezone(std::string new_tz) {
-			std::tie(_tz_name, _tz) = get_zone(new_tz);
+			date::tzdb_pin db;
+			std::tie(_tz_name, _tz) = get_zone(db, new_tz, date::floor<seconds>(*_time_point));
+			_db = db;
+		}
+		//Leaves the timezone unchanged and returns false if new_tz can't be resolved
+		bool try_set_timezone(std::string new_tz) noexcept {
+			date::tzdb_pin db;
+			std::pair<std::string, const time_zone*> found = try_get_zone(db, new_tz, date::floor<seconds>(*_time_point));
+			if (found.second == nullptr) {
+				return false;
+			}
+			std::swap(_tz_name, found.first);
+			_tz = found.second;
+			_db = db;
+			return true;
 		}
+		//The caller has to keep new_tz valid, as there is no tzdb to pin for a zone passed in
 		void set_timezone(const date::time_zone* new_tz) {
 			_tz = new_tz;
 			_tz_name = _tz->name();
+			_db = date::tzdb_pin {};
 		}
 		const date::time_zone* get_timezone() const {
 			return _tz;
@@ -483,7 +555,7 @@ namespace datetime {
 			if (_tz == nullptr) {
 				return date::format(format, date::floor<seconds>(*_time_point));
 			}
-			return date::format(format, date::floor<seconds>(GetZonedTime().get_local_time()));
+			return date::format(format, date::floor<seconds>(_tz->to_local(*_time_point)));
 		}
 		std::string get_offset_from(const DateTime& other, bool include_zones = false) const {
 			std::string out {""};
@@ -491,7 +563,7 @@ namespace datetime {
 			system_duration offset = *_time_point - *(other._time_point);
 
 			if (include_zones && _tz != nullptr && other._tz != nullptr) {
-				offset += GetZonedTime().get_info().offset - other.GetZonedTime().get_info().offset;
+				offset += _tz->get_offset(*_time_point) - other._tz->get_offset(*other._time_point);
 			}
 
 			if (offset.count() == 0) {
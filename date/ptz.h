@@ -42,7 +42,7 @@
 // They are provided here as a non-trivial custom time zone example, and if you really
 // have to have Posix time zones, you're welcome to use this one.
 
-#include "date/tz.h"
+#include "tz.h"
 #include <cctype>
 #include <ostream>
 #include <string>
@@ -69,7 +69,8 @@ void throw_invalid(const string_t& s, unsigned i, const string_t& message);
 unsigned read_date(const string_t& s, unsigned i, rule& r);
 unsigned read_name(const string_t& s, unsigned i, std::string& name);
 unsigned read_signed_time(const string_t& s, unsigned i, std::chrono::seconds& t);
-unsigned read_unsigned_time(const string_t& s, unsigned i, std::chrono::seconds& t);
+unsigned read_unsigned_time(const string_t& s, unsigned i, std::chrono::seconds& t,
+                            unsigned hour_digits = 2);
 unsigned read_unsigned(const string_t& s, unsigned i,  unsigned limit, unsigned& u);
 
 class rule
@@ -195,7 +196,12 @@ time_zone::time_zone(const detail::string_t& s)
         if (i != s.size())
         {
             if (s[i] != ',')
+            {
+                // The daylight offset is given like the standard one:  hours
+                // west of UTC
                 i = read_signed_time(s, i, save_);
+                save_ = -save_ - offset_;
+            }
             if (i != s.size())
             {
                 if (s[i] != ',')
@@ -237,7 +243,35 @@ time_zone::get_info(date::sys_time<Duration> st) const
         auto y = year_month_day{floor<days>(st)}.year();
         auto start = sys_seconds{(start_rule_(y) - offset_).time_since_epoch()};
         auto end   = sys_seconds{(end_rule_(y) - (offset_ + save_)).time_since_epoch()};
-        if (start <= st && st < end)
+        if (end < start)
+        {
+            // Southern hemisphere:  daylight saving time spans the new year
+            if (end <= st && st < start)
+            {
+                r.begin = end;
+                r.end = start;
+                r.abbrev = std_abbrev_;
+            }
+            else
+            {
+                if (st < end)
+                {
+                    r.begin = sys_seconds{(start_rule_(y-years{1}) -
+                                           offset_).time_since_epoch()};
+                    r.end = end;
+                }
+                else
+                {
+                    r.begin = start;
+                    r.end = sys_seconds{(end_rule_(y+years{1}) -
+                                         (offset_ + save_)).time_since_epoch()};
+                }
+                r.offset += save_;
+                r.save = ceil<minutes>(save_);
+                r.abbrev = dst_abbrev_;
+            }
+        }
+        else if (start <= st && st < end)
         {
             r.begin = start;
             r.end = end;
@@ -273,6 +307,7 @@ date::local_info
 time_zone::get_info(date::local_time<Duration> tp) const
 {
     using date::local_info;
+    using date::sys_info;
     using date::year_month_day;
     using date::days;
     using date::sys_days;
@@ -294,7 +329,58 @@ time_zone::get_info(date::local_time<Duration> tp) const
         auto end   = sys_seconds{(end_rule_(y) - (offset_ + save_)).time_since_epoch()};
         auto utcs = sys_seconds{floor<seconds>(tp - offset_).time_since_epoch()};
         auto utcd = sys_seconds{floor<seconds>(tp - (offset_ + save_)).time_since_epoch()};
-        if ((utcs < start) != (utcd < start))
+        if (end < start)
+        {
+            // Southern hemisphere:  daylight saving time spans the new year
+            sys_info std_info{};
+            std_info.begin = end;
+            std_info.end = start;
+            std_info.offset = offset_;
+            std_info.abbrev = std_abbrev_;
+            sys_info dst_info{};
+            dst_info.offset = offset_ + save_;
+            dst_info.save = ceil<minutes>(save_);
+            dst_info.abbrev = dst_abbrev_;
+            if ((utcs < start) != (utcd < start))
+            {
+                dst_info.begin = start;
+                dst_info.end = sys_seconds{(end_rule_(y+years{1}) -
+                                            (offset_ + save_)).time_since_epoch()};
+                r.first = std_info;
+                r.second = dst_info;
+                r.result = save_ > seconds{0} ? local_info::nonexistent
+                                              : local_info::ambiguous;
+            }
+            else if ((utcs < end) != (utcd < end))
+            {
+                dst_info.begin = sys_seconds{(start_rule_(y-years{1}) -
+                                              offset_).time_since_epoch()};
+                dst_info.end = end;
+                r.first = dst_info;
+                r.second = std_info;
+                r.result = save_ > seconds{0} ? local_info::ambiguous
+                                              : local_info::nonexistent;
+            }
+            else if (utcs < end)
+            {
+                dst_info.begin = sys_seconds{(start_rule_(y-years{1}) -
+                                              offset_).time_since_epoch()};
+                dst_info.end = end;
+                r.first = dst_info;
+            }
+            else if (utcs < start)
+            {
+                r.first = std_info;
+            }
+            else
+            {
+                dst_info.begin = start;
+                dst_info.end = sys_seconds{(end_rule_(y+years{1}) -
+                                            (offset_ + save_)).time_since_epoch()};
+                r.first = dst_info;
+            }
+        }
+        else if ((utcs < start) != (utcd < start))
         {
             r.first.begin = sys_seconds{(end_rule_(y-years{1}) -
                                          (offset_ + save_)).time_since_epoch()};
@@ -480,9 +566,13 @@ read_date(const string_t& s, unsigned i, rule& r)
     if (i != s.size() && s[i] == '/')
     {
         ++i;
+        // Version 3 TZif footers allow -167 through 167 hours here
+        bool negative = i != s.size() && s[i] == '-';
+        if (negative || (i != s.size() && s[i] == '+'))
+            ++i;
         std::chrono::seconds t;
-        i = read_unsigned_time(s, i, t);
-        r.time_ = t;
+        i = read_unsigned_time(s, i, t, 3);
+        r.time_ = negative ? -t : t;
     }
     return i;
 }
@@ -544,7 +634,8 @@ read_signed_time(const string_t& s, unsigned i,
 
 inline
 unsigned
-read_unsigned_time(const string_t& s, unsigned i, std::chrono::seconds& t)
+read_unsigned_time(const string_t& s, unsigned i, std::chrono::seconds& t,
+                   unsigned hour_digits)
 {
     using std::chrono::seconds;
     using std::chrono::minutes;
@@ -552,7 +643,7 @@ read_unsigned_time(const string_t& s, unsigned i, std::chrono::seconds& t)
     if (i == s.size())
         throw_invalid(s, i, "Expected to read unsigned time, but found end of string");
     unsigned x;
-    i = read_unsigned(s, i, 2, x);
+    i = read_unsigned(s, i, hour_digits, x);
     t = hours{x};
     if (i != s.size() && s[i] == ':')
     {
@@ -82,6 +82,26 @@ static_assert(HAS_REMOTE_API == 0 ? AUTO_DOWNLOAD == 0 : true,
 #  define USE_SHELL_API 1
 #endif
 
+// HAS_ZLIB reads tzdata .tar.gz archives in process:  an install path ending in
+// .tar.gz or .tgz is loaded straight from the archive, and downloads are unpacked
+// without running tar or 7-Zip.
+#ifndef HAS_ZLIB
+#  define HAS_ZLIB 0
+#endif
+
+// EMBEDDED_TZDB builds the database from a tzdb image generated out of the bundled
+// timezones/ folder by tools/embed_tzdata.cpp, so no tzdata folder is read and no
+// transition table is built at run time.
+#ifndef EMBEDDED_TZDB
+#  define EMBEDDED_TZDB 0
+#endif
+
+static_assert(!(USE_OS_TZDB && EMBEDDED_TZDB),
+              "USE_OS_TZDB and EMBEDDED_TZDB can not be used together");
+
+static_assert(EMBEDDED_TZDB ? AUTO_DOWNLOAD == 0 : true,
+              "AUTO_DOWNLOAD can not be turned on with EMBEDDED_TZDB");
+
 #if USE_OS_TZDB
 #  ifdef _WIN32
 #    error "USE_OS_TZDB can not be used on Windows"
@@ -105,6 +125,14 @@ static_assert(HAS_REMOTE_API == 0 ? AUTO_DOWNLOAD == 0 : true,
 #  endif
 #endif  // HAS_DEDUCTION_GUIDES
 
+#ifndef HAS_SPAN
+#  if __cplusplus >= 202002 || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#    define HAS_SPAN 1
+#  else
+#    define HAS_SPAN 0
+#  endif
+#endif  // HAS_SPAN
+
 #include "date.h"
 
 #if defined(_MSC_VER) && (_MSC_VER < 1900)
@@ -126,6 +154,9 @@ static_assert(HAS_REMOTE_API == 0 ? AUTO_DOWNLOAD == 0 : true,
 #include <type_traits>
 #include <utility>
 #include <vector>
+#if HAS_SPAN
+#  include <span>
+#endif
 
 #ifdef _WIN32
 #  ifdef DATE_BUILD_DLL
@@ -148,6 +179,28 @@ namespace date
 
 enum class choose {earliest, latest};
 
+// How time_zone::to_sys_batch maps local times that are ambiguous or
+// nonexistent.  earliest and latest act as choose does.  shift_forward takes
+// the earlier of two ambiguous mappings and moves a nonexistent time forward by
+// the length of the gap.  flag writes sys_seconds::min() for either.
+enum class to_sys_policy {earliest, latest, shift_forward, flag};
+
+// Outcome of each element of time_zone::to_sys_batch, numbered as in
+// local_info::result.
+enum class to_sys_status : unsigned char {unique, nonexistent, ambiguous};
+
+// Outcome of the try_ lookups, which report what locate_zone, get_info and
+// to_sys would throw instead of throwing it.
+enum class tz_status : unsigned char
+{
+    ok,
+    not_found,     // no zone or link has the name
+    out_of_range,  // the year is outside of the database, or a local time is at its edge
+    nonexistent,   // the local time is skipped by a transition
+    ambiguous,     // the local time occurs twice
+    unavailable    // the database or the data of the zone could not be loaded
+};
+
 namespace detail
 {
     struct undocumented;
@@ -284,8 +337,12 @@ class time_zone;
 
 #if HAS_STRING_VIEW
 DATE_API const time_zone* locate_zone(std::string_view tz_name);
+DATE_API tz_status try_locate_zone(std::string_view tz_name,
+                                   const time_zone*& zone) NOEXCEPT;
 #else
 DATE_API const time_zone* locate_zone(const std::string& tz_name);
+DATE_API tz_status try_locate_zone(const std::string& tz_name,
+                                   const time_zone*& zone) NOEXCEPT;
 #endif
 
 DATE_API const time_zone* current_zone();
@@ -771,14 +828,25 @@ namespace detail
 #  if USE_OS_TZDB
     struct transition;
     struct expanded_ttinfo;
+    struct posix_footer;
 #  else  // !USE_OS_TZDB
     struct zonelet;
+    struct zonelet_abbrev;
     class Rule;
+    struct transition_table;
+    struct transition_registry;
+    struct recurring_rules;
+    struct abbrev_interner;
+    struct string_interner;
 #  endif  // !USE_OS_TZDB
 }
 
 #endif  // !defined(_MSC_VER) || (_MSC_VER >= 1900)
 
+struct tzdb;
+struct tzdb_memory;
+struct prefetch_result;
+
 class time_zone
 {
 private:
@@ -786,27 +854,53 @@ private:
 #if USE_OS_TZDB
     std::vector<detail::transition>      transitions_;
     std::vector<detail::expanded_ttinfo> ttinfos_;
+    std::unique_ptr<detail::posix_footer> footer_;
+    sys_seconds                          footer_begin_ = sys_seconds::max();
 #else  // !USE_OS_TZDB
     std::vector<detail::zonelet>         zonelets_;
+    std::vector<detail::zonelet_abbrev>  zonelet_abbrevs_;
+    std::shared_ptr<const detail::transition_table> table_;
+    std::shared_ptr<const detail::recurring_rules> recurring_;
+    bool                                 fixed_ = false;
+    bool                                 mapped_ = false;
+    const std::string*                   abbrevs_ = nullptr;
+    const std::vector<detail::Rule>*     rules_ = nullptr;
+    const std::vector<std::string>*      strings_ = nullptr;
 #endif  // !USE_OS_TZDB
-    std::unique_ptr<std::once_flag>      adjusted_;
+    mutable std::atomic<bool>            initialized_{false};
 
 public:
-#if !defined(_MSC_VER) || (_MSC_VER >= 1900)
-    time_zone(time_zone&&) = default;
-    time_zone& operator=(time_zone&&) = default;
-#else   // defined(_MSC_VER) && (_MSC_VER < 1900)
-    time_zone(time_zone&& src);
-    time_zone& operator=(time_zone&& src);
-#endif  // defined(_MSC_VER) && (_MSC_VER < 1900)
+    DATE_API ~time_zone();
+    DATE_API time_zone(time_zone&& src);
+    DATE_API time_zone& operator=(time_zone&& src);
 
+#if USE_OS_TZDB
     DATE_API explicit time_zone(const std::string& s, detail::undocumented);
+#else  // !USE_OS_TZDB
+    DATE_API time_zone(const std::string& s, detail::string_interner& strings,
+                       detail::undocumented);
+    // Copies src into a tzdb built from the same definition, keeping the work
+    // done on src so far.
+    DATE_API time_zone(const time_zone& src, detail::undocumented);
+#endif  // !USE_OS_TZDB
 
     const std::string& name() const NOEXCEPT;
 
     template <class Duration> sys_info   get_info(sys_time<Duration> st) const;
     template <class Duration> local_info get_info(local_time<Duration> tp) const;
 
+    // Same abbreviation as get_info(tp).abbrev, copied from the one the database
+    // holds instead of formatted anew.
+    template <class Duration>
+        std::string get_abbrev(sys_time<Duration> tp) const;
+
+    // Same as get_info(tp).offset and get_info(tp).first.offset, without
+    // building a sys_info.
+    template <class Duration>
+        std::chrono::seconds get_offset(sys_time<Duration> tp) const;
+    template <class Duration>
+        std::chrono::seconds get_offset(local_time<Duration> tp) const;
+
     template <class Duration>
         sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>
         to_sys(local_time<Duration> tp) const;
@@ -819,17 +913,72 @@ public:
         local_time<typename std::common_type<Duration, std::chrono::seconds>::type>
         to_local(sys_time<Duration> tp) const;
 
+    // As get_info and to_sys, but without throwing.  try_to_sys reports an
+    // ambiguous or nonexistent local time in its result and still stores the
+    // time to_sys(tp, choose::earliest) gives.
+    template <class Duration>
+        tz_status try_get_info(sys_time<Duration> tp, sys_info& info) const NOEXCEPT;
+    template <class Duration>
+        tz_status try_get_info(local_time<Duration> tp, local_info& info) const NOEXCEPT;
+    template <class Duration>
+        tz_status
+        try_to_sys(local_time<Duration> tp,
+                   sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>& st)
+            const NOEXCEPT;
+
+    // Convert n instants at once.  Input sorted by time is handled in a single
+    // pass over the zone's transitions; out of order elements are looked up
+    // one at a time.
+    DATE_API void to_local_batch(const sys_seconds* tp, std::size_t n,
+                                 local_seconds* out) const;
+    DATE_API void get_offsets(const sys_seconds* tp, std::size_t n,
+                              std::chrono::seconds* out) const;
+
+    // Convert n local times without throwing, resolving the ambiguous and
+    // nonexistent ones by policy.  status, if not null, receives the outcome of
+    // every element.  Sorted input is handled in a single pass as above.
+    DATE_API void to_sys_batch(const local_seconds* tp, std::size_t n, sys_seconds* out,
+                               to_sys_status* status, to_sys_policy policy) const;
+#if HAS_SPAN
+    void to_local_batch(std::span<const sys_seconds> tp,
+                        std::span<local_seconds> out) const;
+    void get_offsets(std::span<const sys_seconds> tp,
+                     std::span<std::chrono::seconds> out) const;
+    void to_sys_batch(std::span<const local_seconds> tp, std::span<sys_seconds> out,
+                      std::span<to_sys_status> status, to_sys_policy policy) const;
+#endif  // HAS_SPAN
+
     friend bool operator==(const time_zone& x, const time_zone& y) NOEXCEPT;
     friend bool operator< (const time_zone& x, const time_zone& y) NOEXCEPT;
     friend DATE_API std::ostream& operator<<(std::ostream& os, const time_zone& z);
+    friend DATE_API tzdb_memory memory_usage(const tzdb& db);
+    friend DATE_API prefetch_result prefetch_zones(const tzdb& db,
+                                                   const std::vector<std::string>& names,
+                                                   unsigned threads);
+    friend DATE_API prefetch_result prefetch_zones(const tzdb& db, unsigned threads);
 
 #if !USE_OS_TZDB
-    DATE_API void add(const std::string& s);
+    DATE_API void add(const std::string& s, detail::string_interner& strings);
+    DATE_API void intern_abbrevs(const std::vector<detail::Rule>& rules,
+                                 const std::vector<std::string>& strings,
+                                 detail::abbrev_interner& interner, detail::undocumented);
+    DATE_API void attach(const tzdb& db, detail::undocumented);
+    DATE_API void used_rules(const std::vector<std::string>& strings,
+                             std::vector<std::string>& names, detail::undocumented) const;
+    DATE_API void share_table(detail::transition_registry& tables, detail::undocumented);
+    DATE_API void map_table(std::shared_ptr<const detail::transition_table> table,
+                            detail::undocumented);
+    DATE_API const detail::transition_table* get_table(detail::undocumented) const;
 #endif  // !USE_OS_TZDB
 
 private:
     DATE_API sys_info   get_info_impl(sys_seconds tp) const;
     DATE_API local_info get_info_impl(local_seconds tp) const;
+    DATE_API std::string get_abbrev_impl(sys_seconds tp) const;
+    DATE_API std::chrono::seconds get_offset_impl(sys_seconds tp) const;
+    DATE_API std::chrono::seconds get_offset_impl(local_seconds tp) const;
+    DATE_API tz_status try_get_info_impl(sys_seconds tp, sys_info& info) const NOEXCEPT;
+    DATE_API tz_status try_get_info_impl(local_seconds tp, local_info& info) const NOEXCEPT;
 
     template <class Duration>
         sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>
@@ -843,39 +992,41 @@ private:
     DATE_API void init_impl();
     DATE_API sys_info
         load_sys_info(std::vector<detail::transition>::const_iterator i) const;
+    DATE_API std::vector<detail::transition>::const_iterator
+        find_transition(sys_seconds tp) const;
+    DATE_API std::vector<detail::transition>::const_iterator
+        find_local_transition(local_seconds tp) const;
+    DATE_API void       attach_footer(const std::string& s);
+    DATE_API sys_info   footer_info(sys_seconds tp) const;
+    DATE_API sys_info   info_at(sys_seconds tp) const;
+    DATE_API local_info footer_local_info(local_seconds tp) const;
 
     template <class TimeType>
     DATE_API void
-    load_data(std::istream& inf, std::int32_t tzh_leapcnt, std::int32_t tzh_timecnt,
-                                 std::int32_t tzh_typecnt, std::int32_t tzh_charcnt);
+    load_data(const unsigned char* p, std::int32_t tzh_leapcnt, std::int32_t tzh_timecnt,
+                                      std::int32_t tzh_typecnt, std::int32_t tzh_charcnt);
 #else  // !USE_OS_TZDB
+    DATE_API void init() const;
+    DATE_API void init_impl();
+    DATE_API bool prepare(sys_seconds tp) const;
+    DATE_API bool prepare(local_seconds tp) const;
     DATE_API sys_info   get_info_impl(sys_seconds tp, int timezone) const;
-    DATE_API void adjust_infos(const std::vector<detail::Rule>& rules);
-    DATE_API void parse_info(std::istream& in);
+    DATE_API sys_info   get_info_impl(sys_seconds tp, int timezone,
+                                      std::uint16_t& abbrev) const;
+    DATE_API const std::vector<detail::Rule>& get_rules() const;
+    DATE_API const std::vector<std::string>& get_strings() const;
+    DATE_API void adjust_infos(const std::vector<detail::Rule>& rules,
+                               const std::vector<std::string>& strings);
+    DATE_API void compile_recurring(const std::vector<detail::Rule>& rules);
+    DATE_API void build_transitions();
+    DATE_API std::size_t find_transition(sys_seconds tp) const;
+    DATE_API std::size_t find_local_transition(local_seconds tp) const;
+    bool is_fixed_at(sys_seconds tp) const;
+    DATE_API sys_info   load_sys_info(std::size_t i) const;
+    DATE_API void parse_info(std::istream& in, detail::string_interner& strings);
 #endif  // !USE_OS_TZDB
 };
 
-#if defined(_MSC_VER) && (_MSC_VER < 1900)
-
-inline
-time_zone::time_zone(time_zone&& src)
-    : name_(std::move(src.name_))
-    , zonelets_(std::move(src.zonelets_))
-    , adjusted_(std::move(src.adjusted_))
-    {}
-
-inline
-time_zone&
-time_zone::operator=(time_zone&& src)
-{
-    name_ = std::move(src.name_);
-    zonelets_ = std::move(src.zonelets_);
-    adjusted_ = std::move(src.adjusted_);
-    return *this;
-}
-
-#endif  // defined(_MSC_VER) && (_MSC_VER < 1900)
-
 inline
 const std::string&
 time_zone::name() const NOEXCEPT
@@ -899,6 +1050,98 @@ time_zone::get_info(local_time<Duration> tp) const
     return get_info_impl(date::floor<std::chrono::seconds>(tp));
 }
 
+template <class Duration>
+inline
+tz_status
+time_zone::try_get_info(sys_time<Duration> tp, sys_info& info) const NOEXCEPT
+{
+    return try_get_info_impl(date::floor<std::chrono::seconds>(tp), info);
+}
+
+template <class Duration>
+inline
+tz_status
+time_zone::try_get_info(local_time<Duration> tp, local_info& info) const NOEXCEPT
+{
+    return try_get_info_impl(date::floor<std::chrono::seconds>(tp), info);
+}
+
+template <class Duration>
+tz_status
+time_zone::try_to_sys(local_time<Duration> tp,
+                      sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>& st)
+    const NOEXCEPT
+{
+    local_info i;
+    auto r = try_get_info(tp, i);
+    if (r != tz_status::ok)
+        return r;
+    if (i.result == local_info::nonexistent)
+    {
+        st = i.first.end;
+        return tz_status::nonexistent;
+    }
+    st = sys_time<Duration>{tp.time_since_epoch()} - i.first.offset;
+    return i.result == local_info::ambiguous ? tz_status::ambiguous : tz_status::ok;
+}
+
+template <class Duration>
+inline
+std::string
+time_zone::get_abbrev(sys_time<Duration> tp) const
+{
+    return get_abbrev_impl(date::floor<std::chrono::seconds>(tp));
+}
+
+template <class Duration>
+inline
+std::chrono::seconds
+time_zone::get_offset(sys_time<Duration> tp) const
+{
+    return get_offset_impl(date::floor<std::chrono::seconds>(tp));
+}
+
+template <class Duration>
+inline
+std::chrono::seconds
+time_zone::get_offset(local_time<Duration> tp) const
+{
+    return get_offset_impl(date::floor<std::chrono::seconds>(tp));
+}
+
+#if HAS_SPAN
+
+inline
+void
+time_zone::to_local_batch(std::span<const sys_seconds> tp,
+                          std::span<local_seconds> out) const
+{
+    assert(out.size() >= tp.size());
+    to_local_batch(tp.data(), tp.size(), out.data());
+}
+
+inline
+void
+time_zone::get_offsets(std::span<const sys_seconds> tp,
+                       std::span<std::chrono::seconds> out) const
+{
+    assert(out.size() >= tp.size());
+    get_offsets(tp.data(), tp.size(), out.data());
+}
+
+inline
+void
+time_zone::to_sys_batch(std::span<const local_seconds> tp, std::span<sys_seconds> out,
+                        std::span<to_sys_status> status, to_sys_policy policy) const
+{
+    assert(out.size() >= tp.size());
+    assert(status.empty() || status.size() >= tp.size());
+    to_sys_batch(tp.data(), tp.size(), out.data(),
+                 status.empty() ? nullptr : status.data(), policy);
+}
+
+#endif  // HAS_SPAN
+
 template <class Duration>
 inline
 sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>
@@ -921,8 +1164,7 @@ local_time<typename std::common_type<Duration, std::chrono::seconds>::type>
 time_zone::to_local(sys_time<Duration> tp) const
 {
     using LT = local_time<typename std::common_type<Duration, std::chrono::seconds>::type>;
-    auto i = get_info(tp);
-    return LT{(tp + i.offset).time_since_epoch()};
+    return LT{(tp + get_offset(tp)).time_since_epoch()};
 }
 
 inline bool operator==(const time_zone& x, const time_zone& y) NOEXCEPT {return x.name_ == y.name_;}
@@ -1155,6 +1397,57 @@ struct timezone_mapping
 
 #endif  // _WIN32
 
+namespace detail
+{
+
+// One slot of the open addressed name index of a tzdb.  name is a zone or
+// link name and zone the time_zone it resolves to.  Empty slots have no name.
+struct zone_name_slot
+{
+    const std::string* name = nullptr;
+    const time_zone*   zone = nullptr;
+    std::size_t        hash = 0;
+};
+
+struct abbrev_index;
+
+#if !USE_OS_TZDB
+
+// A region file a tzdb was parsed from:  a hash of its contents, what it
+// defined, and the rules its zones use.  A reload copies what an unchanged file
+// defined from the previous tzdb instead of parsing it again.
+struct tzdata_source
+{
+    std::string              file;
+    std::uint64_t            hash = 0;
+    std::vector<std::string> zones;
+    std::vector<std::string> rules;
+    std::vector<std::string> links;
+    std::vector<std::string> uses;
+    bool                     leap_seconds = false;
+};
+
+#endif  // !USE_OS_TZDB
+
+}  // namespace detail
+
+// Result of tzdb::find_zone
+struct zone_match
+{
+    const std::string* name = nullptr;  // spelling of the zone or link name found
+    const time_zone*   zone = nullptr;  // nullptr if nothing was found
+};
+
+// An interval over which a zone used an abbreviation, as listed by
+// tzdb::find_abbrev.  Adjoining intervals with the same offset are merged.
+struct abbrev_zone
+{
+    const time_zone*     zone = nullptr;
+    std::chrono::seconds offset {};  // the offset the abbreviation stood for
+    sys_seconds          begin;
+    sys_seconds          end;
+};
+
 struct tzdb
 {
     std::string                 version = "unknown";
@@ -1167,10 +1460,22 @@ struct tzdb
 #endif
 #if !USE_OS_TZDB
     std::vector<detail::Rule>   rules;
+    // The rule names, formats and rule letters that rules and zones refer to
+    // by index.  Index 0 is the empty string.
+    std::vector<std::string>    strings;
+    std::vector<std::string>    abbrevs;
+    std::vector<detail::tzdata_source> sources;
 #endif
 #ifdef _WIN32
     std::vector<detail::timezone_mapping> mappings;
 #endif
+    // Hash indexes over every zone and link name, built by the loader.  The
+    // second one ignores ASCII case.
+    std::vector<detail::zone_name_slot> name_index;
+    std::vector<detail::zone_name_slot> name_index_nocase;
+    // Index from abbreviations to the zones that used them, filled in by the
+    // first call to find_abbrev or locate_abbrev, which initializes every zone
+    std::shared_ptr<detail::abbrev_index> abbrev_index;
     tzdb* next = nullptr;
 
     tzdb() = default;
@@ -1184,7 +1489,13 @@ struct tzdb
         , links(std::move(src.links))
         , leap_seconds(std::move(src.leap_seconds))
         , rules(std::move(src.rules))
+        , strings(std::move(src.strings))
+        , abbrevs(std::move(src.abbrevs))
+        , sources(std::move(src.sources))
         , mappings(std::move(src.mappings))
+        , name_index(std::move(src.name_index))
+        , name_index_nocase(std::move(src.name_index_nocase))
+        , abbrev_index(std::move(src.abbrev_index))
     {}
 
     tzdb& operator=(tzdb&& src)
@@ -1194,17 +1505,48 @@ struct tzdb
         links = std::move(src.links);
         leap_seconds = std::move(src.leap_seconds);
         rules = std::move(src.rules);
+        strings = std::move(src.strings);
+        abbrevs = std::move(src.abbrevs);
+        sources = std::move(src.sources);
         mappings = std::move(src.mappings);
+        name_index = std::move(src.name_index);
+        name_index_nocase = std::move(src.name_index_nocase);
+        abbrev_index = std::move(src.abbrev_index);
         return *this;
     }
 #endif  // defined(_MSC_VER) && (_MSC_VER < 1900)
 
 #if HAS_STRING_VIEW
     const time_zone* locate_zone(std::string_view tz_name) const;
+    tz_status try_locate_zone(std::string_view tz_name,
+                              const time_zone*& zone) const NOEXCEPT;
+    zone_match find_zone(std::string_view tz_name, bool ignore_case = false) const NOEXCEPT;
 #else
     const time_zone* locate_zone(const std::string& tz_name) const;
+    tz_status try_locate_zone(const std::string& tz_name,
+                              const time_zone*& zone) const NOEXCEPT;
+    zone_match find_zone(const std::string& tz_name, bool ignore_case = false) const NOEXCEPT;
 #endif
     const time_zone* current_zone() const;
+
+    // The intervals over which zones used abbrev as found in sys_info::abbrev,
+    // up to 2100.  Those of a zone are together and in time order.  The zones
+    // come in order of their first use of it, those named after a place first,
+    // then the names kept for backward compatibility, then the likes of CET or
+    // EST5EDT.  Empty if no zone used it.
+#if HAS_STRING_VIEW
+    const std::vector<abbrev_zone>& find_abbrev(std::string_view abbrev) const;
+#else
+    const std::vector<abbrev_zone>& find_abbrev(const std::string& abbrev) const;
+#endif
+    // The first zone of find_abbrev(abbrev) that used it at tp, or nullptr if
+    // there is none.  Each zone's intervals are binary searched, and past 2100
+    // the zones that still use it are asked.
+#if HAS_STRING_VIEW
+    const time_zone* locate_abbrev(std::string_view abbrev, sys_seconds tp) const;
+#else
+    const time_zone* locate_abbrev(const std::string& abbrev, sys_seconds tp) const;
+#endif
 };
 
 using TZ_DB = tzdb;
@@ -1212,6 +1554,88 @@ using TZ_DB = tzdb;
 DATE_API std::ostream&
 operator<<(std::ostream& os, const tzdb& db);
 
+// Heap and object bytes held by a tzdb.  transitions only counts the zones
+// whose tables have been built by a lookup so far.  strings includes the
+// rule names, formats and abbreviations of the tzdb.
+struct tzdb_memory
+{
+    std::size_t zones        = 0;
+    std::size_t transitions  = 0;
+    std::size_t links        = 0;
+    std::size_t rules        = 0;
+    std::size_t leap_seconds = 0;
+    std::size_t strings      = 0;
+
+    std::size_t total() const
+    {
+        return zones + transitions + links + rules + leap_seconds + strings;
+    }
+};
+
+DATE_API tzdb_memory memory_usage(const tzdb& db);
+
+DATE_API std::ostream&
+operator<<(std::ostream& os, const tzdb_memory& m);
+
+// Counts for the calling thread's cache of the last interval get_info found
+// in each zone.  Time ordered lookups in a zone mostly hit it.
+struct info_cache_stats
+{
+    std::uint64_t hits   = 0;
+    std::uint64_t misses = 0;
+};
+
+DATE_API info_cache_stats get_info_cache_stats() NOEXCEPT;
+DATE_API void reset_info_cache_stats() NOEXCEPT;
+
+// Outcome of prefetch_zones.  loaded counts the zones this call initialized,
+// failed the names not found plus the zones that could not be loaded.
+struct prefetch_result
+{
+    std::size_t              loaded = 0;
+    std::size_t              failed = 0;
+    std::chrono::nanoseconds elapsed{0};
+};
+
+// Initializes zones ahead of their first lookup, spread over threads worker
+// threads (0 means one per hardware thread), and returns once all are done.
+// With USE_OS_TZDB this reads their zoneinfo files.  The second form loads
+// every zone of db, which for USE_OS_TZDB is every file under get_tz_dir().
+DATE_API prefetch_result prefetch_zones(const tzdb& db, const std::vector<std::string>& names,
+                                        unsigned threads = 0);
+DATE_API prefetch_result prefetch_zones(const tzdb& db, unsigned threads = 0);
+
+#if !USE_OS_TZDB
+
+// Writes z as a TZif version 3 file (RFC 8536):  its transitions up to where
+// its final rules take over, then those rules as a POSIX TZ string.  A
+// USE_OS_TZDB build can load a tree of these, see tools/export_tzif.cpp.
+DATE_API void write_tzif(std::ostream& os, const time_zone& z);
+
+// A tzdb image is one file holding the tzdata text a tzdb was parsed from and
+// the transition tables of all of its zones, laid out by offset so that each
+// process can map it read-only wherever it likes.  Zones loaded from an image
+// look up times inside of the table window straight from the mapping, without
+// being initialized, so the tables are built once and held in memory once per
+// host.  Times outside of the window still go through the rules.
+//
+// Once a path is set, loading the database (first use, reload_tzdb or a
+// refresh) maps the image there if it was built from the installed version,
+// or from anything when there is no install.  Otherwise the database is built
+// from the install as before, and the image written for the next process.
+// The image is written under another name and renamed into place, so that
+// processes mapping an older one are not disturbed.  Writing it builds every
+// table first, on prefetch_zones' threads, which takes a few hundred
+// milliseconds.  A path on a RAM backed file system, such as /dev/shm, acts as
+// a named shared memory segment.  An image that does not belong to the current
+// user, that others can write to, or whose contents fail their checksum is
+// ignored and rebuilt.  Set the path before the database is first used.  An
+// EMBEDDED_TZDB build has its image compiled in, and ignores the path.
+DATE_API void               set_tzdb_image(const std::string& path);
+DATE_API const std::string& get_tzdb_image();
+
+#endif  // !USE_OS_TZDB
+
 DATE_API const tzdb& get_tzdb();
 
 class tzdb_list
@@ -1304,6 +1728,47 @@ tzdb_list::cend() const noexcept
 
 DATE_API tzdb_list& get_tzdb_list();
 
+// Pins the front of get_tzdb_list() for as long as the snapshot lives.  Taking
+// and releasing one never blocks.  While reclamation is enabled (see
+// tzdb_refresh_options), a tzdb that is no longer the front is deleted once
+// no snapshot or tzdb_pin refers to it, so references into it must come from
+// one of those.
+class tzdb_snapshot
+{
+    const tzdb* db_;
+    unsigned    slot_;
+
+public:
+    DATE_API tzdb_snapshot();
+    DATE_API ~tzdb_snapshot();
+
+    tzdb_snapshot(const tzdb_snapshot&) = delete;
+    tzdb_snapshot& operator=(const tzdb_snapshot&) = delete;
+
+    const tzdb& operator*() const noexcept {return *db_;}
+    const tzdb* operator->() const noexcept {return db_;}
+};
+
+// Keeps the tzdb of a snapshot from being reclaimed for as long as a copy of
+// the pin lives, for holding on to its zones past the snapshot.  Taking,
+// copying and releasing a pin take a mutex.  A default constructed pin holds
+// nothing.
+class tzdb_pin
+{
+    const tzdb* db_ = nullptr;
+
+public:
+    tzdb_pin() = default;
+    DATE_API explicit tzdb_pin(const tzdb_snapshot& snapshot);
+    DATE_API tzdb_pin(const tzdb_pin& pin);
+    DATE_API tzdb_pin& operator=(const tzdb_pin& pin);
+    DATE_API ~tzdb_pin();
+
+    explicit operator bool() const noexcept {return db_ != nullptr;}
+    const tzdb& operator*() const noexcept {return *db_;}
+    const tzdb* operator->() const noexcept {return db_;}
+};
+
 #if !USE_OS_TZDB
 
 DATE_API const tzdb& reload_tzdb();
@@ -1311,10 +1776,52 @@ DATE_API void        set_install(const std::string& install);
 DATE_API const std::string& get_install();
 DATE_API std::string get_version(const std::string& path);
 
+struct tzdb_refresh_options
+{
+    // Time between checks for a new version
+    std::chrono::seconds interval = std::chrono::hours{24};
+    // Delete tzdbs that have been replaced once no tzdb_snapshot or tzdb_pin
+    // holds them, instead of keeping every version in get_tzdb_list() until
+    // exit.  This also deletes their zones:  a time_zone pointer kept past the
+    // next refresh, as from locate_zone, get_tzdb() or in a zoned_time, has to
+    // come with a tzdb_pin (DateTime holds one), or reclaim be turned off.
+    bool                 reclaim = true;
+};
+
+// Starts a thread that periodically builds a new tzdb when the installed (or,
+// with AUTO_DOWNLOAD, the remote) version changes, and publishes it as the new
+// front of get_tzdb_list().  A failed check is retried at the next interval.
+// With reclaim on, the thread also deletes the tzdbs replaced so far once
+// their last snapshot and pin are gone.  Calling it again replaces the options
+// of the running thread.
+DATE_API void start_tzdb_refresh(const tzdb_refresh_options& options = {});
+DATE_API void stop_tzdb_refresh();
+
 #endif  // !USE_OS_TZDB
 
 #if HAS_REMOTE_API
 
+struct remote_options
+{
+    // Page naming the current release, as "/time-zones/releases/tzdata<version>"
+    std::string               version_url = "https://www.iana.org/time-zones";
+    // Releases are fetched from release_url + "tzdata" + version + ".tar.gz"
+    std::string               release_url = "https://data.iana.org/time-zones/releases/";
+    // Windows only
+    std::string               mapping_url = "https://raw.githubusercontent.com/unicode-org/"
+                                            "cldr/master/common/supplemental/windowsZones.xml";
+    // Limit on connecting to the server
+    std::chrono::milliseconds connect_timeout = std::chrono::seconds{10};
+    // Limit on each whole request, connecting included
+    std::chrono::milliseconds timeout = std::chrono::seconds{30};
+    // Send the ETag and Last-Modified of earlier responses, kept in
+    // get_install() + ".http_cache", so that unchanged data costs a 304
+    bool                      revalidate = true;
+};
+
+DATE_API void           set_remote_options(const remote_options& options);
+DATE_API remote_options get_remote_options();
+
 DATE_API std::string remote_version();
 // if provided error_buffer size should be at least CURL_ERROR_SIZE
 DATE_API bool        remote_download(const std::string& version, char* error_buffer = nullptr);
@@ -1322,6 +1829,16 @@ DATE_API bool        remote_install(const std::string& version);
 
 #endif
 
+#if AUTO_DOWNLOAD
+
+// When an install exists, the first use of the database serves it without
+// asking the remote.  A thread then looks for a newer version and, once it is
+// installed, publishes it as the new front of get_tzdb_list().  Waits up to
+// timeout for that thread and returns true if it has finished.
+DATE_API bool wait_tzdb_update(std::chrono::milliseconds timeout);
+
+#endif
+
 // zoned_time
 
 namespace detail
@@ -1888,37 +2405,68 @@ template <class Duration>
 
 using utc_seconds = utc_time<std::chrono::seconds>;
 
+namespace detail
+{
+
+// The leap second dates of the front tzdb as seconds since 1970.  A table is
+// never changed or freed once published, so a reference to it stays valid
+// without pinning the tzdb it came from.
+struct leap_table
+{
+    std::vector<std::int64_t> dates;
+
+    sys_seconds date(std::size_t i) const
+    {
+        return sys_seconds{std::chrono::seconds{dates[i]}};
+    }
+
+    // Same as upper_bound(leap_seconds.begin(), leap_seconds.end(), tp) -
+    // leap_seconds.begin(), checking for a time after the last leap second
+    // first.
+    template <class Duration>
+    std::size_t
+    upper_bound(const sys_time<Duration>& tp) const
+    {
+        auto const n = dates.size();
+        if (n == 0 || tp >= date(n-1))
+            return n;
+        return static_cast<std::size_t>(
+            std::upper_bound(dates.begin(), dates.end(), tp,
+                [](const sys_time<Duration>& x, std::int64_t y)
+                {
+                    return x < sys_seconds{std::chrono::seconds{y}};
+                }) - dates.begin());
+    }
+};
+
+DATE_API const leap_table& get_leap_table();
+
 template <class Duration>
 utc_time<typename std::common_type<Duration, std::chrono::seconds>::type>
-utc_clock::from_sys(const sys_time<Duration>& st)
+utc_from_sys(const leap_table& leaps, const sys_time<Duration>& st)
 {
     using std::chrono::seconds;
     using CD = typename std::common_type<Duration, seconds>::type;
-    auto const& leaps = get_tzdb().leap_seconds;
-    auto const lt = std::upper_bound(leaps.begin(), leaps.end(), st);
-    return utc_time<CD>{st.time_since_epoch() + seconds{lt-leaps.begin()}};
+    auto const lt = leaps.upper_bound(st);
+    return utc_time<CD>{st.time_since_epoch() + seconds{static_cast<seconds::rep>(lt)}};
 }
 
-// Return pair<is_leap_second, seconds{number_of_leap_seconds_since_1970}>
-// first is true if ut is during a leap second insertion, otherwise false.
-// If ut is during a leap second insertion, that leap second is included in the count
 template <class Duration>
 std::pair<bool, std::chrono::seconds>
-is_leap_second(date::utc_time<Duration> const& ut)
+is_leap_second(const leap_table& leaps, date::utc_time<Duration> const& ut)
 {
     using std::chrono::seconds;
     using duration = typename std::common_type<Duration, seconds>::type;
-    auto const& leaps = get_tzdb().leap_seconds;
     auto tp = sys_time<duration>{ut.time_since_epoch()};
-    auto const lt = std::upper_bound(leaps.begin(), leaps.end(), tp);
-    auto ds = seconds{lt-leaps.begin()};
+    auto const lt = leaps.upper_bound(tp);
+    auto ds = seconds{static_cast<seconds::rep>(lt)};
     tp -= ds;
     auto ls = false;
-    if (lt > leaps.begin())
+    if (lt > 0)
     {
-        if (tp < lt[-1])
+        if (tp < leaps.date(lt-1))
         {
-            if (tp >= lt[-1].date() - seconds{1})
+            if (tp >= leaps.date(lt-1) - seconds{1})
                 ls = true;
             else
                 --ds;
@@ -1927,6 +2475,38 @@ is_leap_second(date::utc_time<Duration> const& ut)
     return {ls, ds};
 }
 
+template <class Duration>
+sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>
+utc_to_sys(const leap_table& leaps, const utc_time<Duration>& ut)
+{
+    using std::chrono::seconds;
+    using CD = typename std::common_type<Duration, seconds>::type;
+    auto ls = is_leap_second(leaps, ut);
+    auto tp = sys_time<CD>{ut.time_since_epoch() - ls.second};
+    if (ls.first)
+        tp = floor<seconds>(tp) + seconds{1} - CD{1};
+    return tp;
+}
+
+}  // namespace detail
+
+template <class Duration>
+utc_time<typename std::common_type<Duration, std::chrono::seconds>::type>
+utc_clock::from_sys(const sys_time<Duration>& st)
+{
+    return detail::utc_from_sys(detail::get_leap_table(), st);
+}
+
+// Return pair<is_leap_second, seconds{number_of_leap_seconds_since_1970}>
+// first is true if ut is during a leap second insertion, otherwise false.
+// If ut is during a leap second insertion, that leap second is included in the count
+template <class Duration>
+std::pair<bool, std::chrono::seconds>
+is_leap_second(date::utc_time<Duration> const& ut)
+{
+    return detail::is_leap_second(detail::get_leap_table(), ut);
+}
+
 struct leap_second_info
 {
     bool is_leap_second;
@@ -1945,13 +2525,7 @@ template <class Duration>
 sys_time<typename std::common_type<Duration, std::chrono::seconds>::type>
 utc_clock::to_sys(const utc_time<Duration>& ut)
 {
-    using std::chrono::seconds;
-    using CD = typename std::common_type<Duration, seconds>::type;
-    auto ls = is_leap_second(ut);
-    auto tp = sys_time<CD>{ut.time_since_epoch() - ls.second};
-    if (ls.first)
-        tp = floor<seconds>(tp) + seconds{1} - CD{1};
-    return tp;
+    return detail::utc_to_sys(detail::get_leap_table(), ut);
 }
 
 inline
@@ -2688,6 +3262,105 @@ clock_cast(const std::chrono::time_point<SrcClock, Duration>& tp)
     return clock_cast_detail::cc_impl<DstClock>(tp, &tp);
 }
 
+// clock_cast over arrays of sys, utc, tai and gps time points.  The leap
+// second table is fetched once for the whole array.
+
+namespace detail
+{
+
+template <class Duration>
+inline
+utc_time<typename std::common_type<Duration, std::chrono::seconds>::type>
+to_utc(const leap_table& leaps, const sys_time<Duration>& t)
+{
+    return utc_from_sys(leaps, t);
+}
+
+template <class Duration>
+inline
+utc_time<typename std::common_type<Duration, std::chrono::seconds>::type>
+to_utc(const leap_table&, const utc_time<Duration>& t)
+{
+    return t;
+}
+
+template <class Duration>
+inline
+utc_time<typename std::common_type<Duration, std::chrono::seconds>::type>
+to_utc(const leap_table&, const tai_time<Duration>& t)
+{
+    return tai_clock::to_utc(t);
+}
+
+template <class Duration>
+inline
+utc_time<typename std::common_type<Duration, std::chrono::seconds>::type>
+to_utc(const leap_table&, const gps_time<Duration>& t)
+{
+    return gps_clock::to_utc(t);
+}
+
+template <class Duration>
+inline
+sys_time<Duration>
+from_utc(const leap_table& leaps, const utc_time<Duration>& t, std::chrono::system_clock*)
+{
+    return utc_to_sys(leaps, t);
+}
+
+template <class Duration>
+inline
+utc_time<Duration>
+from_utc(const leap_table&, const utc_time<Duration>& t, utc_clock*)
+{
+    return t;
+}
+
+template <class Duration>
+inline
+tai_time<Duration>
+from_utc(const leap_table&, const utc_time<Duration>& t, tai_clock*)
+{
+    return tai_clock::from_utc(t);
+}
+
+template <class Duration>
+inline
+gps_time<Duration>
+from_utc(const leap_table&, const utc_time<Duration>& t, gps_clock*)
+{
+    return gps_clock::from_utc(t);
+}
+
+}  // namespace detail
+
+template <class DstClock, class SrcClock, class Duration>
+void
+clock_cast_batch(const std::chrono::time_point<SrcClock, Duration>* tp, std::size_t n,
+                 std::chrono::time_point<DstClock,
+                     typename std::common_type<Duration, std::chrono::seconds>::type>* out)
+{
+    auto const& leaps = detail::get_leap_table();
+    for (std::size_t j = 0; j < n; ++j)
+        out[j] = detail::from_utc(leaps, detail::to_utc(leaps, tp[j]),
+                                  static_cast<DstClock*>(nullptr));
+}
+
+#if HAS_SPAN
+
+template <class DstClock, class SrcClock, class Duration>
+inline
+void
+clock_cast_batch(std::span<const std::chrono::time_point<SrcClock, Duration>> tp,
+                 std::span<std::chrono::time_point<DstClock,
+                     typename std::common_type<Duration, std::chrono::seconds>::type>> out)
+{
+    assert(out.size() >= tp.size());
+    clock_cast_batch<DstClock>(tp.data(), tp.size(), out.data());
+}
+
+#endif  // HAS_SPAN
+
 // Deprecated API
 
 template <class Duration>
@@ -42,6 +42,32 @@ namespace detail
 
 #if !USE_OS_TZDB
 
+// The region files read by the text parser, in the order it reads them.
+// tools/embed_tzdata.cpp embeds the same files.
+CONSTDATA char* const tzdata_files[] =
+{
+    "africa", "antarctica", "asia", "australasia", "backward", "etcetera", "europe",
+    "pacificnew", "northamerica", "southamerica", "systemv", "leapseconds"
+};
+
+// Builds the tzdb of files, the region files and optionally windowsZones.xml,
+// and lays it out as a tzdb image (see set_tzdb_image) with every table built.
+// tools/embed_tzdata.cpp compiles the result into an EMBEDDED_TZDB build, so
+// the two have to be built with the same configuration.
+DATE_API std::string make_tzdb_image(const std::string& version,
+                                     const std::vector<std::pair<std::string, std::string>>& files);
+
+#if EMBEDDED_TZDB
+
+// The image written by tools/embed_tzdata.cpp, aligned to 8 bytes.  It holds
+// the text of the region files, with the comment and blank lines already
+// stripped, and the transition tables of their zones.
+extern const char          embedded_tzdata_version[];
+extern const unsigned char embedded_tzdb_image[];
+extern const std::size_t   embedded_tzdb_image_size;
+
+#endif  // EMBEDDED_TZDB
+
 enum class tz {utc, local, standard};
 
 //forward declare to avoid warnings in gcc 6.2
@@ -133,35 +159,42 @@ public:
 
 //forward declare to avoid warnings in gcc 6.2
 class Rule;
+struct string_interner;
 bool operator==(const Rule& x, const Rule& y);
 bool operator<(const Rule& x, const Rule& y);
 bool operator==(const Rule& x, const date::year& y);
 bool operator<(const Rule& x, const date::year& y);
 bool operator==(const date::year& x, const Rule& y);
 bool operator<(const date::year& x, const Rule& y);
-bool operator==(const Rule& x, const std::string& y);
-bool operator<(const Rule& x, const std::string& y);
-bool operator==(const std::string& x, const Rule& y);
-bool operator<(const std::string& x, const Rule& y);
-std::ostream& operator<<(std::ostream& os, const Rule& r);
 
+// A Rule along with the strings of its tzdb, for printing
+struct named_rule
+{
+    const Rule&                     rule;
+    const std::vector<std::string>& strings;
+};
+
+std::ostream& operator<<(std::ostream& os, const named_rule& r);
+
+// Rules sort by the index of their name in tzdb::strings, which keeps the
+// rules of one name together, though not in the order of the names.
 class Rule
 {
 private:
-    std::string          name_;
+    std::uint16_t        name_{0};    // index into tzdb::strings
+    std::uint16_t        abbrev_{0};  // index into tzdb::strings
     date::year           starting_year_{0};
     date::year           ending_year_{0};
     MonthDayTime         starting_at_;
     std::chrono::minutes save_{0};
-    std::string          abbrev_;
 
 public:
     Rule() = default;
-    explicit Rule(const std::string& s);
+    Rule(const std::string& s, string_interner& strings);
     Rule(const Rule& r, date::year starting_year, date::year ending_year);
 
-    const std::string& name() const {return name_;}
-    const std::string& abbrev() const {return abbrev_;}
+    std::uint16_t name_id()   const {return name_;}
+    std::uint16_t abbrev_id() const {return abbrev_;}
 
     const MonthDayTime&         mdt()           const {return starting_at_;}
     const date::year&           starting_year() const {return starting_year_;}
@@ -176,12 +209,8 @@ public:
     friend bool operator<(const Rule& x, const date::year& y);
     friend bool operator==(const date::year& x, const Rule& y);
     friend bool operator<(const date::year& x, const Rule& y);
-    friend bool operator==(const Rule& x, const std::string& y);
-    friend bool operator<(const Rule& x, const std::string& y);
-    friend bool operator==(const std::string& x, const Rule& y);
-    friend bool operator<(const std::string& x, const Rule& y);
 
-    friend std::ostream& operator<<(std::ostream& os, const Rule& r);
+    friend std::ostream& operator<<(std::ostream& os, const named_rule& r);
 
 private:
     date::day day() const;
@@ -207,15 +236,20 @@ inline bool operator> (const date::year& x, const Rule& y) {return   y < x;}
 inline bool operator<=(const date::year& x, const Rule& y) {return !(y < x);}
 inline bool operator>=(const date::year& x, const Rule& y) {return !(x < y);}
 
-inline bool operator!=(const Rule& x, const std::string& y) {return !(x == y);}
-inline bool operator> (const Rule& x, const std::string& y) {return   y < x;}
-inline bool operator<=(const Rule& x, const std::string& y) {return !(y < x);}
-inline bool operator>=(const Rule& x, const std::string& y) {return !(x < y);}
+// One abbreviation a zonelet can produce: the Rule letters and save it is
+// formatted from, and its index into tzdb::abbrevs.
+struct zonelet_abbrev
+{
+    std::chrono::minutes save;
+    std::uint16_t        letters;
+    std::uint16_t        id;
+};
+
+// Index of an abbreviation that is not in tzdb::abbrevs
+CONSTDATA std::uint16_t no_abbrev = 0xFFFF;
 
-inline bool operator!=(const std::string& x, const Rule& y) {return !(x == y);}
-inline bool operator> (const std::string& x, const Rule& y) {return   y < x;}
-inline bool operator<=(const std::string& x, const Rule& y) {return !(y < x);}
-inline bool operator>=(const std::string& x, const Rule& y) {return !(x < y);}
+// Place of a zonelet's rule that is not in effect
+CONSTDATA std::uint16_t no_rule = 0xFFFF;
 
 struct zonelet
 {
@@ -230,43 +264,98 @@ struct zonelet
     struct U
 #endif
     {
-        std::string          rule_;
+        std::uint16_t        rule_;  // index into tzdb::strings
         std::chrono::minutes save_;
+    } u {};
+
+    std::uint16_t                        format_{0};          // index into tzdb::strings
+    std::uint16_t                        initial_abbrev_{0};  // index into tzdb::strings
+    date::year                           until_year_{0};
+    MonthDayTime                         until_date_;
+    sys_seconds                          until_utc_;
+    local_seconds                        until_std_;
+    local_seconds                        until_loc_;
+    std::chrono::minutes                 initial_save_{};
+    // The first and last rule in effect, by their place in the run of rules
+    // named rule_, so that they stay valid in any tzdb with the same rules
+    std::pair<std::uint16_t, date::year> first_rule_{no_rule, date::year::min()};
+    std::pair<std::uint16_t, date::year> last_rule_{no_rule, date::year::max()};
+    // The abbreviations this zonelet can produce, in time_zone::zonelet_abbrevs_
+    std::uint16_t                        abbrevs_offset_{0};
+    std::uint16_t                        abbrevs_count_{0};
+};
 
-        ~U() {}
-        U() {}
-        U(const U&) {}
-        U& operator=(const U&) = delete;
-    } u;
+// The rules that the last zonelet of a zone follows every year from first_year
+// on, in the order they take effect within a year.  Compiled when the zone is
+// initialized, so that a later year is evaluated directly instead of walking
+// the rules from the start of the zonelet.
+struct recurring_rule
+{
+    MonthDayTime         mdt;
+    std::chrono::minutes save;
+    std::uint16_t        letters;  // index into tzdb::strings
+};
 
-    std::string                        format_;
-    date::year                         until_year_{0};
-    MonthDayTime                       until_date_;
-    sys_seconds                        until_utc_;
-    local_seconds                      until_std_;
-    local_seconds                      until_loc_;
-    std::chrono::minutes               initial_save_{};
-    std::string                        initial_abbrev_;
-    std::pair<const Rule*, date::year> first_rule_{nullptr, date::year::min()};
-    std::pair<const Rule*, date::year> last_rule_{nullptr, date::year::max()};
-
-    ~zonelet();
-    zonelet();
-    zonelet(const zonelet& i);
-    zonelet& operator=(const zonelet&) = delete;
+CONSTDATA std::size_t max_recurring_rules = 4;
+
+struct recurring_rules
+{
+    date::year                  first_year;
+    std::chrono::seconds        gmtoff;
+    std::vector<recurring_rule> rules;
 };
 
-#else  // USE_OS_TZDB
+// One entry of the precomputed transition table built by time_zone::init().
+// Entry i is in effect from begin up to, but not including, the begin of
+// entry i+1.
+struct zone_transition
+{
+    sys_seconds   begin;
+    std::int32_t  offset;  // seconds
+    std::int16_t  save;    // minutes
+    std::uint16_t abbrev;
+};
 
-struct ttinfo
+static_assert(sizeof(zone_transition) == 16, "");
+
+// Read-only view of an array held by a transition_table or mapped from a tzdb
+// image
+template <class T>
+struct table_view
 {
-    std::int32_t  tt_gmtoff;
-    unsigned char tt_isdst;
-    unsigned char tt_abbrind;
-    unsigned char pad[2];
+    const T*    first = nullptr;
+    std::size_t count = 0;
+
+    table_view() = default;
+    table_view(const T* p, std::size_t n) : first(p), count(n) {}
+    table_view(const std::vector<T>& v) : first(v.data()), count(v.size()) {}
+
+    std::size_t size() const {return count;}
+    bool empty() const {return count == 0;}
+    const T* begin() const {return first;}
+    const T* end() const {return first + count;}
+    const T& operator[](std::size_t i) const {return first[i];}
+    const T& front() const {return first[0];}
 };
 
-static_assert(sizeof(ttinfo) == 8, "");
+// The precomputed lookup table of a time_zone: its transitions over the
+// window, an index over them by bucket, and the end of the last entry.  Zones
+// whose tables are equal may share one.  A table built in this process keeps
+// its arrays in the storage members; one mapped from a tzdb image has none.
+struct transition_table
+{
+    table_view<zone_transition>  transitions;
+    table_view<std::uint16_t>    index;
+    sys_seconds                  end;
+    std::vector<zone_transition> transition_storage;
+    std::vector<std::uint16_t>   index_storage;
+
+    transition_table() = default;
+    transition_table(const transition_table&) = delete;
+    transition_table& operator=(const transition_table&) = delete;
+};
+
+#else  // USE_OS_TZDB
 
 struct expanded_ttinfo
 {
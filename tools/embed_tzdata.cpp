@@ -0,0 +1,135 @@
+// Generates the tzdb image used by an EMBEDDED_TZDB build of tz.cpp.
+//
+// usage: embed_tzdata <tzdata folder> <output .cpp file>
+//
+// Every region file the text parser reads is stripped of its comment and blank
+// lines, and built into a tzdb image (see set_tzdb_image) along with the
+// transition tables of all of its zones and, on Windows, windowsZones.xml.  The
+// image is written out as a constant byte array, so the library builds its tzdb
+// without touching the file system or building any table.  Compile the output
+// alongside tz.cpp with EMBEDDED_TZDB=1 defined.  This tool links a tz.cpp built
+// without EMBEDDED_TZDB but otherwise alike, as the image has to match the table
+// years and layout of the library.  DateTime.vcxproj does both when built with
+// /p:EmbeddedTzdb=true; by hand:
+//     cl /EHsc /std:c++latest /I. /DHAS_REMOTE_API=0 /DAUTO_DOWNLOAD=0 tools\embed_tzdata.cpp tz.cpp ole32.lib shell32.lib
+//     embed_tzdata.exe timezones tzdata_embedded.cpp
+
+#include "date/tz_private.h"
+
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	bool read_file(const std::string& path, std::string& out) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open()) {
+			return false;
+		}
+		std::ostringstream buf;
+		buf << in.rdbuf();
+		out = buf.str();
+		return true;
+	}
+
+	//The parser skips these lines anyway, and dropping them keeps the tables to roughly a fifth of the source size
+	std::string strip_comments(const std::string& text) {
+		std::string out;
+		std::istringstream in(text);
+		std::string line;
+		while (std::getline(in, line)) {
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t") == std::string::npos) {
+				continue;
+			}
+			out += line;
+			out += '\n';
+		}
+		return out;
+	}
+
+	//MSVC caps string literals at 64KB, so the data is written as a byte array instead
+	//The tables are read in place, hence the alignment
+	void write_array(std::ostream& out, const std::string& name, const std::string& data) {
+		out << "alignas(8) const unsigned char " << name << "[] = {";
+		for (std::size_t i = 0; i < data.size(); i++) {
+			if (i % 20 == 0) {
+				out << "\n\t";
+			}
+			out << static_cast<int>(static_cast<unsigned char>(data[i])) << ',';
+		}
+		out << "\n};\n\n";
+	}
+
+}
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::cerr << "usage: embed_tzdata <tzdata folder> <output .cpp file>\n";
+		return 1;
+	}
+	std::string folder = argv[1];
+	if (!folder.empty() && folder.back() != '/' && folder.back() != '\\') {
+		folder += '/';
+	}
+
+	std::string version;
+	if (!read_file(folder + "version", version)) {
+		std::cerr << "Unable to read " << folder << "version\n";
+		return 1;
+	}
+	version = version.substr(0, version.find_first_of("\r\n"));
+
+	std::vector<std::string> names(std::begin(date::detail::tzdata_files), std::end(date::detail::tzdata_files));
+	names.push_back("windowsZones.xml");
+
+	std::vector<std::pair<std::string, std::string>> files;
+	for (const std::string& name : names) {
+		std::string text;
+		if (!read_file(folder + name, text)) {
+			if (name == "windowsZones.xml") {
+				continue;
+			}
+			std::cerr << "Unable to read " << folder << name << '\n';
+			return 1;
+		}
+		if (name != "windowsZones.xml") {
+			text = strip_comments(text);
+		}
+		files.emplace_back(name, text);
+	}
+
+	std::string image;
+	try {
+		image = date::detail::make_tzdb_image(version, files);
+	} catch (const std::exception& e) {
+		std::cerr << "Unable to build the tzdb image: " << e.what() << '\n';
+		return 1;
+	}
+
+	std::ostringstream out;
+	out << "// Generated by tools/embed_tzdata.cpp from tzdata " << version << ".  Do not edit.\n\n";
+	out << "#include \"date/tz_private.h\"\n\n";
+	out << "#if EMBEDDED_TZDB\n\n";
+	out << "namespace date {\n\nnamespace detail {\n\n";
+	out << "const char embedded_tzdata_version[] = \"" << version << "\";\n\n";
+	write_array(out, "embedded_tzdb_image", image);
+	out << "const std::size_t embedded_tzdb_image_size = " << image.size() << ";\n\n";
+	out << "}  // namespace detail\n\n}  // namespace date\n\n";
+	out << "#endif  // EMBEDDED_TZDB\n";
+
+	std::ofstream outfile(argv[2], std::ios::binary);
+	if (!outfile.is_open()) {
+		std::cerr << "Unable to write " << argv[2] << '\n';
+		return 1;
+	}
+	outfile << out.str();
+	return 0;
+}
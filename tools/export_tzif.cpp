@@ -0,0 +1,74 @@
+// Writes a zoneinfo tree from tzdata source files.
+//
+// usage: export_tzif <tzdata folder> <output folder>
+//
+// Every zone and link the text parser finds is written as a TZif version 3 file
+// named after it (America/New_York becomes <output folder>/America/New_York), along
+// with +VERSION.  A USE_OS_TZDB build can then load the tree in place of the system
+// zoneinfo by setting TZDIR to the output folder.  Build against the rule-based
+// library, e.g.:
+//     cl /EHsc /std:c++latest /I. /DHAS_REMOTE_API=0 tools\export_tzif.cpp tz.cpp
+//     export_tzif.exe timezones zoneinfo
+
+#include "date/tz.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+	bool write_zone(const std::filesystem::path& path, const date::time_zone& zone) {
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream out(path, std::ios::binary);
+		if (!out.is_open()) {
+			return false;
+		}
+		date::write_tzif(out, zone);
+		return static_cast<bool>(out);
+	}
+
+}
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::cerr << "usage: export_tzif <tzdata folder> <output folder>\n";
+		return 1;
+	}
+	std::filesystem::path root = argv[2];
+	try {
+		date::set_install(argv[1]);
+		const date::tzdb& db = date::get_tzdb();
+
+		std::size_t files = 0;
+		for (const date::time_zone& zone : db.zones) {
+			if (!write_zone(root / zone.name(), zone)) {
+				std::cerr << "Unable to write " << (root / zone.name()).string() << '\n';
+				return 1;
+			}
+			files++;
+		}
+		//Links get a copy of their target, which also works where symbolic links don't
+		for (const date::time_zone_link& link : db.links) {
+			const date::time_zone* zone = db.locate_zone(link.target());
+			if (!write_zone(root / link.name(), *zone)) {
+				std::cerr << "Unable to write " << (root / link.name()).string() << '\n';
+				return 1;
+			}
+			files++;
+		}
+
+		std::ofstream version(root / "+VERSION", std::ios::binary);
+		version << db.version << '\n';
+		if (!version) {
+			std::cerr << "Unable to write " << (root / "+VERSION").string() << '\n';
+			return 1;
+		}
+		std::cout << "Wrote " << files << " zones from tzdata " << db.version << '\n';
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -93,27 +93,38 @@
 #  define TARGET_OS_IPHONE 0
 #endif
 
+#include "date/ptz.h"
 #if USE_OS_TZDB
 #  include <dirent.h>
 #endif
 #include <algorithm>
 #include <cctype>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <cwchar>
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <set>
 #if USE_OS_TZDB
 #  include <queue>
 #endif
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <sys/stat.h>
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#endif
 
 // unistd.h is used on some platforms as part of the the means to get
 // the current time zone. On Win32 windows.h provides a means to do it.
@@ -169,6 +180,10 @@ struct IUnknown;    // fix for issue with static_cast<> in objbase.h
 #endif
 #endif
 
+#if HAS_ZLIB && !USE_OS_TZDB
+#  include <zlib.h>
+#endif
+
 #ifdef _WIN32
     static CONSTDATA char folder_delimiter = '\\';
 #else   // !_WIN32
@@ -305,6 +320,23 @@ namespace date {
         return ref;
     }
 
+    static
+    std::string&
+    access_tzdb_image() {
+        static std::string image;
+        return image;
+    }
+
+    void
+        set_tzdb_image(const std::string& path) {
+        access_tzdb_image() = path;
+    }
+
+    const std::string&
+        get_tzdb_image() {
+        return access_tzdb_image();
+    }
+
 #if HAS_REMOTE_API
     static
         std::string
@@ -314,6 +346,19 @@ namespace date {
     }
 #endif  // HAS_REMOTE_API
 
+#if !EMBEDDED_TZDB || HAS_REMOTE_API
+
+    // Held while the install folder is replaced or read, so a background
+    // update can not swap the files out from under init_tzdb
+    static
+        std::mutex&
+        get_install_mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+#endif  // !EMBEDDED_TZDB || HAS_REMOTE_API
+
 #endif  // !USE_OS_TZDB
 
     // These can be used to reduce the range of the database to save memory
@@ -323,6 +368,33 @@ namespace date {
     CONSTDATA auto min_day = date::January / 1;
     CONSTDATA auto max_day = date::December / 31;
 
+#if !USE_OS_TZDB
+
+    // Years covered by the precomputed transition table of each time_zone.
+    // Lookups outside of this window fall back to evaluating the rules.
+#  ifndef TRANSITION_TABLE_FIRST_YEAR
+#    define TRANSITION_TABLE_FIRST_YEAR 1900
+#  endif
+#  ifndef TRANSITION_TABLE_LAST_YEAR
+#    define TRANSITION_TABLE_LAST_YEAR 2100
+#  endif
+
+    // Nonzero to build every table at load and have zones with equal tables
+    // share one.  Saves memory at the cost of a slower load.
+#  ifndef SHARE_TRANSITION_TABLES
+#    define SHARE_TRANSITION_TABLES 0
+#  endif
+
+    CONSTDATA auto transition_first_year = date::year {TRANSITION_TABLE_FIRST_YEAR};
+    CONSTDATA auto transition_last_year = date::year {TRANSITION_TABLE_LAST_YEAR};
+
+    // Width of a bucket in the index over the transition table
+    CONSTDATA auto transition_bucket = date::days {365};
+
+    static_assert(transition_first_year <= transition_last_year, "Configuration error");
+
+#endif  // !USE_OS_TZDB
+
 #if USE_OS_TZDB
 
     CONSTCD14 const sys_seconds min_seconds = sys_days(min_year / min_day);
@@ -336,6 +408,11 @@ namespace date {
         discover_tz_dir() {
         struct stat sb;
         using namespace std;
+        // As for the C library, TZDIR names another tree, such as one written
+        // by tools/export_tzif
+        if (auto tzdir = std::getenv("TZDIR"))
+            if (stat(tzdir, &sb) == 0 && S_ISDIR(sb.st_mode))
+                return tzdir;
 #  ifndef __APPLE__
         CONSTDATA auto tz_dir_default = "/usr/share/zoneinfo";
         CONSTDATA auto tz_dir_buildroot = "/usr/share/zoneinfo/uclibc";
@@ -388,7 +465,7 @@ namespace date {
     static_assert(min_year <= max_year, "Configuration error");
 #endif
 
-    static std::unique_ptr<tzdb> init_tzdb();
+    static std::unique_ptr<tzdb> init_tzdb(const tzdb* prev = nullptr);
 
     tzdb_list::~tzdb_list() {
         const tzdb* ptr = head_;
@@ -422,6 +499,14 @@ namespace date {
         static void push_front(tzdb_list& db_list, tzdb* tzdb) noexcept {
             db_list.push_front(tzdb);
         }
+
+        // Unlinks every tzdb after the front and returns the first of them
+        static tzdb* split_after_front(tzdb_list& db_list) noexcept {
+            tzdb* front = db_list.head_;
+            auto rest = front->next;
+            front->next = nullptr;
+            return rest;
+        }
     };
 
     static
@@ -432,12 +517,341 @@ namespace date {
         return tz_db;
     }
 
+#if AUTO_DOWNLOAD
+    static void start_tzdb_update();
+#endif
+
     tzdb_list&
         get_tzdb_list() {
         static tzdb_list tz_db = create_tzdb();
+#if AUTO_DOWNLOAD
+        // Started after, and so stopped before, tz_db is destroyed
+        static const bool updating = (start_tzdb_update(), true);
+        (void)updating;
+#endif
         return tz_db;
     }
 
+    // tzdb_snapshot
+
+    namespace {
+
+        struct alignas(64) reader_count {
+            std::atomic<long> n {0};
+        };
+
+        // A snapshot counts itself in the slot of the epoch it was taken in.
+        // Only the publisher advances the epoch, and only once the slot of the
+        // previous epoch has drained, so every live snapshot was taken in the
+        // current epoch or the one before it.  Hence a tzdb retired in epoch r
+        // can not be held by anyone once the epoch reaches r + 2.
+        std::atomic<unsigned> tzdb_epoch {0};
+        reader_count          tzdb_readers[2];
+
+        // The number of tzdb_pins on each pinned tzdb
+        struct tzdb_pins {
+            std::mutex                                 mutex;
+            std::unordered_map<const tzdb*, std::size_t> count;
+        };
+
+    }  // unnamed namespace
+
+    // Never destroyed, as pins in static storage may outlive anything else
+    static
+        tzdb_pins&
+        get_tzdb_pins() {
+        static tzdb_pins* pins = new tzdb_pins;
+        return *pins;
+    }
+
+    tzdb_snapshot::tzdb_snapshot() {
+        auto& db_list = get_tzdb_list();
+        while (true) {
+            auto e = tzdb_epoch.load();
+            slot_ = e & 1;
+            tzdb_readers[slot_].n.fetch_add(1);
+            if (tzdb_epoch.load() == e)
+                break;
+            tzdb_readers[slot_].n.fetch_sub(1);
+        }
+        db_ = &db_list.front();
+    }
+
+    tzdb_snapshot::~tzdb_snapshot() {
+        tzdb_readers[slot_].n.fetch_sub(1, std::memory_order_release);
+    }
+
+    // The snapshot keeps the tzdb from being reclaimed until it is counted
+    tzdb_pin::tzdb_pin(const tzdb_snapshot& snapshot)
+        : db_ {&*snapshot} {
+        auto& pins = get_tzdb_pins();
+        std::lock_guard<std::mutex> lock(pins.mutex);
+        ++pins.count[db_];
+    }
+
+    tzdb_pin::tzdb_pin(const tzdb_pin& pin)
+        : db_ {pin.db_} {
+        if (db_ == nullptr)
+            return;
+        auto& pins = get_tzdb_pins();
+        std::lock_guard<std::mutex> lock(pins.mutex);
+        ++pins.count[db_];
+    }
+
+    tzdb_pin&
+        tzdb_pin::operator=(const tzdb_pin& pin) {
+        if (db_ != pin.db_) {
+            tzdb_pin tmp(pin);
+            std::swap(db_, tmp.db_);
+        }
+        return *this;
+    }
+
+    tzdb_pin::~tzdb_pin() {
+        if (db_ == nullptr)
+            return;
+        auto& pins = get_tzdb_pins();
+        std::lock_guard<std::mutex> lock(pins.mutex);
+        auto i = pins.count.find(db_);
+        if (--i->second == 0)
+            pins.count.erase(i);
+    }
+
+#if !MISSING_LEAP_SECONDS
+
+    namespace {
+
+        struct leap_tables {
+            std::mutex mutex;
+            std::atomic<const detail::leap_table*> current {nullptr};
+            std::vector<std::unique_ptr<detail::leap_table>> all;
+        };
+
+    }  // unnamed namespace
+
+    static
+        leap_tables&
+        get_leap_tables() {
+        static leap_tables tables;
+        return tables;
+    }
+
+    // Makes the leap seconds of db the ones the clocks use, unless an equal
+    // table is current already.  Without replace this only fills in a missing
+    // table.  Replaced tables are kept for readers still holding them.
+    static
+        void
+        publish_leap_table(const tzdb& db, bool replace) {
+        auto& tables = get_leap_tables();
+        std::vector<std::int64_t> dates;
+        dates.reserve(db.leap_seconds.size());
+        for (auto const& x : db.leap_seconds)
+            dates.push_back(x.date().time_since_epoch().count());
+        std::lock_guard<std::mutex> lock(tables.mutex);
+        auto current = tables.current.load(std::memory_order_relaxed);
+        if (current != nullptr && (!replace || current->dates == dates))
+            return;
+        tables.all.emplace_back(new detail::leap_table {std::move(dates)});
+        tables.current.store(tables.all.back().get(), std::memory_order_release);
+    }
+
+    const detail::leap_table&
+        detail::get_leap_table() {
+        auto& tables = get_leap_tables();
+        if (auto p = tables.current.load(std::memory_order_acquire))
+            return *p;
+        {
+            tzdb_snapshot db;
+            publish_leap_table(*db, false);
+        }
+        return *tables.current.load(std::memory_order_acquire);
+    }
+
+#endif  // !MISSING_LEAP_SECONDS
+
+#if !USE_OS_TZDB && !EMBEDDED_TZDB
+
+    namespace {
+
+        struct tzdb_publisher {
+            std::mutex                                mutex;
+            bool                                      reclaim = false;
+            std::vector<std::pair<tzdb*, unsigned>>   retired;
+
+            ~tzdb_publisher() {
+                for (auto& r : retired)
+                    delete r.first;
+            }
+        };
+
+    }  // unnamed namespace
+
+    static
+        tzdb_publisher&
+        get_tzdb_publisher() {
+        static tzdb_publisher publisher;
+        return publisher;
+    }
+
+    // Deletes the retired tzdbs that no snapshot can refer to any more and
+    // no pin holds.  Requires publisher.mutex.
+    static
+        void
+        reclaim_tzdbs(tzdb_publisher& publisher) {
+        for (int i = 0; i < 2 && !publisher.retired.empty(); ++i) {
+            auto e = tzdb_epoch.load();
+            if (tzdb_readers[(e + 1) & 1].n.load() != 0)
+                break;
+            tzdb_epoch.store(e + 1);
+        }
+        auto e = tzdb_epoch.load();
+        auto& retired = publisher.retired;
+        std::vector<tzdb*> unused;
+        {
+            // Once out of every snapshot a tzdb can't gain a pin
+            auto& pins = get_tzdb_pins();
+            std::lock_guard<std::mutex> lock(pins.mutex);
+            for (auto i = retired.begin(); i != retired.end();) {
+                if (e - i->second >= 2 && pins.count.count(i->first) == 0) {
+                    unused.push_back(i->first);
+                    i = retired.erase(i);
+                } else
+                    ++i;
+            }
+        }
+        for (auto p : unused)
+            delete p;
+    }
+
+    // Makes db the front of get_tzdb_list().  With reclamation on, the tzdbs it
+    // replaces are unlinked, to be deleted here or by the refresher once no
+    // snapshot or pin holds them.
+    static
+        void
+        publish_tzdb(std::unique_ptr<tzdb> db) {
+        auto& db_list = get_tzdb_list();
+        auto& publisher = get_tzdb_publisher();
+        std::lock_guard<std::mutex> lock(publisher.mutex);
+        tzdb_list::undocumented_helper::push_front(db_list, db.release());
+#if !MISSING_LEAP_SECONDS
+        publish_leap_table(db_list.front(), true);
+#endif
+        if (publisher.reclaim) {
+            auto e = tzdb_epoch.load();
+            for (auto p = tzdb_list::undocumented_helper::split_after_front(db_list);
+                p != nullptr;) {
+                auto next = p->next;
+                p->next = nullptr;
+                publisher.retired.emplace_back(p, e);
+                p = next;
+            }
+        }
+        reclaim_tzdbs(publisher);
+    }
+
+#endif  // !USE_OS_TZDB && !EMBEDDED_TZDB
+
+    // tzdb name index
+
+    static
+        unsigned char
+        fold_case(char c) {
+        auto u = static_cast<unsigned char>(c);
+        return 'A' <= u && u <= 'Z' ? static_cast<unsigned char>(u - 'A' + 'a') : u;
+    }
+
+    // FNV-1a
+    static
+        std::size_t
+        hash_zone_name(const char* p, std::size_t n, bool ignore_case) {
+        std::uint64_t h = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= ignore_case ? fold_case(p[i]) : static_cast<unsigned char>(p[i]);
+            h *= 1099511628211ULL;
+        }
+        return static_cast<std::size_t>(h);
+    }
+
+    static
+        bool
+        equal_zone_name(const std::string& x, const char* p, std::size_t n, bool ignore_case) {
+        if (x.size() != n)
+            return false;
+        if (!ignore_case)
+            return x.compare(0, n, p, n) == 0;
+        for (std::size_t i = 0; i < n; ++i)
+            if (fold_case(x[i]) != fold_case(p[i]))
+                return false;
+        return true;
+    }
+
+    static
+        const detail::zone_name_slot*
+        find_zone_slot(const std::vector<detail::zone_name_slot>& index, const char* p,
+            std::size_t n, bool ignore_case) {
+        if (index.empty())
+            return nullptr;
+        auto h = hash_zone_name(p, n, ignore_case);
+        auto mask = index.size() - 1;
+        for (auto i = h & mask;; i = (i + 1) & mask) {
+            auto const& s = index[i];
+            if (s.name == nullptr)
+                return nullptr;
+            if (s.hash == h && equal_zone_name(*s.name, p, n, ignore_case))
+                return &s;
+        }
+    }
+
+    // Adds name unless it is already there, which for the case-insensitive
+    // index keeps the first of two names that only differ in case.
+    static
+        void
+        insert_zone_slot(std::vector<detail::zone_name_slot>& index, const std::string& name,
+            const time_zone* zone, bool ignore_case) {
+        if (find_zone_slot(index, name.data(), name.size(), ignore_case) != nullptr)
+            return;
+        auto h = hash_zone_name(name.data(), name.size(), ignore_case);
+        auto mask = index.size() - 1;
+        auto i = h & mask;
+        while (index[i].name != nullptr)
+            i = (i + 1) & mask;
+        index[i].name = &name;
+        index[i].zone = zone;
+        index[i].hash = h;
+    }
+
+    // Builds tzdb::name_index and tzdb::name_index_nocase.  Zones are added
+    // before links.  Requires db.zones to be sorted.
+    static
+        void
+        build_zone_index(tzdb& db) {
+        std::size_t count = db.zones.size();
+#if !USE_OS_TZDB
+        count += db.links.size();
+#endif
+        // Keep the load factor at or below one half
+        std::size_t size = 16;
+        while (size < 2 * count)
+            size *= 2;
+        db.abbrev_index = std::make_shared<detail::abbrev_index>();
+        for (auto index : {&db.name_index, &db.name_index_nocase}) {
+            bool ignore_case = index == &db.name_index_nocase;
+            index->assign(size, detail::zone_name_slot {});
+            for (auto const& z : db.zones)
+                insert_zone_slot(*index, z.name(), &z, ignore_case);
+#if !USE_OS_TZDB
+            for (auto const& l : db.links) {
+                auto zi = std::lower_bound(db.zones.begin(), db.zones.end(), l.target(),
+                    [](const time_zone& z, const std::string& nm) {
+                        return z.name() < nm;
+                    });
+                if (zi != db.zones.end() && zi->name() == l.target())
+                    insert_zone_slot(*index, l.name(), &*zi, ignore_case);
+            }
+#endif  // !USE_OS_TZDB
+        }
+    }
+
 #if !USE_OS_TZDB
 
 #ifdef _WIN32
@@ -492,20 +906,11 @@ namespace date {
     // See timezone_mapping structure for more info.
     static
         std::vector<detail::timezone_mapping>
-        load_timezone_mappings_from_xml_file(const std::string& input_path) {
+        load_timezone_mappings_from_xml(std::istream& is, const std::string& input_path) {
         std::size_t line_num = 0;
         std::vector<detail::timezone_mapping> mappings;
         std::string line;
 
-        std::ifstream is(input_path);
-        if (!is.is_open()) {
-            // We don't emit file exceptions because that's an implementation detail.
-            std::string msg = "Error opening time zone mapping file \"";
-            msg += input_path;
-            msg += "\".";
-            throw std::runtime_error(msg);
-        }
-
         auto error = [&input_path, &line_num](const char* info) {
             std::string msg = "Error loading time zone mapping file \"";
             msg += input_path;
@@ -624,10 +1029,23 @@ namespace date {
             }
         }
 
-        is.close();
         return mappings;
     }
 
+    static
+        std::vector<detail::timezone_mapping>
+        load_timezone_mappings_from_xml_file(const std::string& input_path) {
+        std::ifstream is(input_path);
+        if (!is.is_open()) {
+            // We don't emit file exceptions because that's an implementation detail.
+            std::string msg = "Error opening time zone mapping file \"";
+            msg += input_path;
+            msg += "\".";
+            throw std::runtime_error(msg);
+        }
+        return load_timezone_mappings_from_xml(is, input_path);
+    }
+
 #endif  // _WIN32
 
     // Parsing helpers
@@ -996,16 +1414,46 @@ namespace date {
         return os;
     }
 
+    // Builds tzdb::strings while region files are parsed, handing out one index
+    // per distinct rule name, format and rule letters.  strings may already
+    // hold those of an older tzdb, whose rules and zones keep their indices.
+    struct detail::string_interner {
+        std::vector<std::string>&             strings;
+        std::map<std::string, std::uint16_t> ids;
+
+        explicit string_interner(std::vector<std::string>& s)
+            : strings(s) {
+            if (strings.empty())
+                strings.emplace_back();
+            for (std::size_t i = 0; i < strings.size(); ++i)
+                ids.emplace(strings[i], static_cast<std::uint16_t>(i));
+        }
+
+        std::uint16_t
+            intern(const std::string& s) {
+            auto i = ids.find(s);
+            if (i != ids.end())
+                return i->second;
+            if (strings.size() > std::numeric_limits<std::uint16_t>::max())
+                throw std::runtime_error("Too many distinct names in the time zone database");
+            auto id = static_cast<std::uint16_t>(strings.size());
+            strings.push_back(s);
+            ids.emplace(s, id);
+            return id;
+        }
+    };
+
     // Rule
 
-    detail::Rule::Rule(const std::string& s) {
+    detail::Rule::Rule(const std::string& s, string_interner& strings) {
         try {
             using namespace date;
             using namespace std::chrono;
             std::istringstream in(s);
             in.exceptions(std::ios::failbit | std::ios::badbit);
             std::string word;
-            in >> word >> name_;
+            in >> word >> word;
+            name_ = strings.intern(word);
             int x;
             ws(in);
             if (std::isalpha(in.peek())) {
@@ -1035,24 +1483,25 @@ namespace date {
             assert(word == "-");
             in >> starting_at_;
             save_ = duration_cast<minutes>(parse_signed_time(in));
-            in >> abbrev_;
-            if (abbrev_ == "-")
-                abbrev_.clear();
+            in >> word;
+            if (word == "-")
+                word.clear();
+            abbrev_ = strings.intern(word);
             assert(hours {-1} <= save_ && save_ <= hours {2});
         } catch (...) {
             std::cerr << s << '\n';
-            std::cerr << *this << '\n';
+            std::cerr << named_rule {*this, strings.strings} << '\n';
             throw;
         }
     }
 
     detail::Rule::Rule(const Rule& r, date::year starting_year, date::year ending_year)
         : name_(r.name_)
+        , abbrev_(r.abbrev_)
         , starting_year_(starting_year)
         , ending_year_(ending_year)
         , starting_at_(r.starting_at_)
-        , save_(r.save_)
-        , abbrev_(r.abbrev_) {
+        , save_(r.save_) {
     }
 
     bool
@@ -1097,41 +1546,22 @@ namespace date {
         return x < y.starting_year_;
     }
 
-    bool
-        detail::operator==(const Rule& x, const std::string& y) {
-        return x.name() == y;
-    }
-
-    bool
-        detail::operator<(const Rule& x, const std::string& y) {
-        return x.name() < y;
-    }
-
-    bool
-        detail::operator==(const std::string& x, const Rule& y) {
-        return y.name() == x;
-    }
-
-    bool
-        detail::operator<(const std::string& x, const Rule& y) {
-        return x < y.name();
-    }
-
     std::ostream&
-        detail::operator<<(std::ostream& os, const Rule& r) {
+        detail::operator<<(std::ostream& os, const named_rule& nr) {
         using namespace date;
         using namespace std::chrono;
         detail::save_ostream<char> _(os);
+        auto const& r = nr.rule;
         os.fill(' ');
         os.flags(std::ios::dec | std::ios::left);
         os.width(15);
-        os << r.name_;
+        os << nr.strings[r.name_];
         os << r.starting_year_ << "    " << r.ending_year_ << "    ";
         os << r.starting_at_;
         if (r.save_ >= minutes {0})
             os << ' ';
         os << date::make_time(r.save_) << "   ";
-        os << r.abbrev_;
+        os << nr.strings[r.abbrev_];
         return os;
     }
 
@@ -1146,23 +1576,27 @@ namespace date {
     }
 
     struct find_rule_by_name {
-        bool operator()(const Rule& x, const std::string& nm) const {
-            return x.name() < nm;
+        bool operator()(const Rule& x, std::uint16_t nm) const {
+            return x.name_id() < nm;
         }
 
-        bool operator()(const std::string& nm, const Rule& x) const {
-            return nm < x.name();
+        bool operator()(std::uint16_t nm, const Rule& x) const {
+            return nm < x.name_id();
         }
     };
 
+    // The run of rules named by the string at index name
+    static
+        std::pair<const Rule*, const Rule*>
+        find_rules(const std::vector<Rule>& rules, std::uint16_t name) {
+        return std::equal_range(rules.data(), rules.data() + rules.size(), name,
+            find_rule_by_name {});
+    }
+
     bool
         detail::Rule::overlaps(const Rule& x, const Rule& y) {
         // assume x.starting_year_ <= y.starting_year_;
-        if (!(x.starting_year_ <= y.starting_year_)) {
-            std::cerr << x << '\n';
-            std::cerr << y << '\n';
-            assert(x.starting_year_ <= y.starting_year_);
-        }
+        assert(x.starting_year_ <= y.starting_year_);
         if (y.starting_year_ > x.ending_year_)
             return false;
         return !(x.starting_year_ == y.starting_year_ && x.ending_year_ == y.ending_year_);
@@ -1252,10 +1686,8 @@ namespace date {
         using difference_type = std::vector<Rule>::iterator::difference_type;
         for (std::size_t i = 0; i < rules.size();) {
             auto e = static_cast<std::size_t>(std::upper_bound(
-                rules.cbegin() + static_cast<difference_type>(i), rules.cend(), rules[i].name(),
-                [](const std::string& nm, const Rule& x) {
-                    return nm < x.name();
-                }) - rules.cbegin());
+                rules.cbegin() + static_cast<difference_type>(i), rules.cend(), rules[i].name_,
+                find_rule_by_name {}) - rules.cbegin());
             split_overlaps(rules, i, e);
             auto first_rule = rules.begin() + static_cast<difference_type>(i);
             auto last_rule = rules.begin() + static_cast<difference_type>(e);
@@ -1289,20 +1721,19 @@ namespace date {
     //     r->starting_year() <= y && y <= r->ending_year()
     static
         std::pair<const Rule*, date::year>
-        find_previous_rule(const Rule* r, date::year y) {
+        find_previous_rule(const Rule* r, date::year y, const std::vector<Rule>& rules) {
         using namespace date;
-        auto const& rules = get_tzdb().rules;
         if (y == r->starting_year()) {
-            if (r == &rules.front() || r->name() != r[-1].name())
+            if (r == &rules.front() || r->name_id() != r[-1].name_id())
                 std::terminate();  // never called with first rule
             --r;
             if (y == r->starting_year())
                 return {r, y};
             return {r, r->ending_year()};
         }
-        if (r == &rules.front() || r->name() != r[-1].name() ||
+        if (r == &rules.front() || r->name_id() != r[-1].name_id() ||
             r[-1].starting_year() < r->starting_year()) {
-            while (r < &rules.back() && r->name() == r[1].name() &&
+            while (r < &rules.back() && r->name_id() == r[1].name_id() &&
                 r->starting_year() == r[1].starting_year())
                 ++r;
             return {r, --y};
@@ -1353,16 +1784,16 @@ namespace date {
         find_next_rule(const Rule* r, date::year y, const std::vector<date::detail::Rule>& rules) {
         using namespace date;
         if (y == r->ending_year()) {
-            if (r == &rules.back() || r->name() != r[1].name())
+            if (r == &rules.back() || r->name_id() != r[1].name_id())
                 return {nullptr, year::max()};
             ++r;
             if (y == r->ending_year())
                 return {r, y};
             return {r, r->starting_year()};
         }
-        if (r == &rules.back() || r->name() != r[1].name() ||
+        if (r == &rules.back() || r->name_id() != r[1].name_id() ||
             r->ending_year() < r[1].ending_year()) {
-            while (r > & rules.front() && r->name() == r[-1].name() &&
+            while (r > & rules.front() && r->name_id() == r[-1].name_id() &&
                 r->starting_year() == r[-1].starting_year())
                 --r;
             return {r, ++y};
@@ -1373,14 +1804,15 @@ namespace date {
 
     static
         const Rule*
-        find_first_std_rule(const std::pair<const Rule*, const Rule*>& eqr) {
+        find_first_std_rule(const std::pair<const Rule*, const Rule*>& eqr,
+            const std::vector<std::string>& strings) {
         auto r = eqr.first;
         auto ry = r->starting_year();
         while (r->save() != std::chrono::minutes {0}) {
             std::tie(r, ry) = find_next_rule(eqr.first, eqr.second, r, ry);
             if (r == nullptr)
                 throw std::runtime_error("Could not find standard offset in rule "
-                    + eqr.first->name());
+                    + strings[eqr.first->name_id()]);
         }
         return r;
     }
@@ -1453,14 +1885,14 @@ namespace date {
             const std::pair<const Rule*, date::year>& last_rule,
             const date::year& y, const std::chrono::seconds& offset,
             const MonthDayTime& mdt, const std::chrono::minutes& initial_save,
-            const std::string& initial_abbrev) {
+            std::uint16_t initial_abbrev, const std::vector<Rule>& rules,
+            const std::vector<std::string>& strings) {
         using namespace std::chrono;
         using namespace date;
-        auto const& rules = get_tzdb().rules;
         auto r = first_rule.first;
         auto ry = first_rule.second;
         sys_info x {sys_days(year::min() / min_day), sys_days(year::max() / max_day),
-                   seconds{0}, initial_save, initial_abbrev};
+                   seconds{0}, initial_save, strings[initial_abbrev]};
         auto tx_base = mdt.to_sys(y, seconds(0), seconds(0));
         auto tx_zone = mdt.zone();
         while (r != nullptr) {
@@ -1479,16 +1911,16 @@ namespace date {
                     break;
                 }
                 if (tx < tr) {
-                    std::tie(r, ry) = find_previous_rule(r, ry);  // can't return nullptr for r
+                    std::tie(r, ry) = find_previous_rule(r, ry, rules);  // can't return nullptr for r
                     assert(r != nullptr);
                 }
                 // r != nullptr && tx >= tr (if tr were to be recomputed)
                 auto prev_save = initial_save;
                 if (!(r == first_rule.first && ry == first_rule.second))
-                    prev_save = find_previous_rule(r, ry).first->save();
+                    prev_save = find_previous_rule(r, ry, rules).first->save();
                 x.begin = r->mdt().to_sys(ry, offset, prev_save);
                 x.save = r->save();
-                x.abbrev = r->abbrev();
+                x.abbrev = strings[r->abbrev_id()];
                 if (!(r == last_rule.first && ry == last_rule.second)) {
                     std::tie(r, ry) = find_next_rule(r, ry, rules);  // can't return nullptr for r
                     assert(r != nullptr);
@@ -1504,87 +1936,445 @@ namespace date {
         return x;
     }
 
-    // zonelet
-
-    detail::zonelet::~zonelet() {
-#if !defined(_MSC_VER) || (_MSC_VER >= 1900)
-        using minutes = std::chrono::minutes;
-        using string = std::string;
-        if (tag_ == has_save)
-            u.save_.~minutes();
-        else
-            u.rule_.~string();
-#endif
-    }
+    // Builds tzdb::abbrevs while a database is loaded, handing out one index
+    // per distinct abbreviation.
+    struct detail::abbrev_interner {
+        std::vector<std::string>&             abbrevs;
+        std::map<std::string, std::uint16_t> ids;
+
+        std::uint16_t
+            intern(const std::string& s) {
+            auto i = ids.find(s);
+            if (i != ids.end())
+                return i->second;
+            if (abbrevs.size() >= no_abbrev)
+                return no_abbrev;
+            auto id = static_cast<std::uint16_t>(abbrevs.size());
+            abbrevs.push_back(s);
+            ids.emplace(s, id);
+            return id;
+        }
+    };
 
-    detail::zonelet::zonelet() {
-#if !defined(_MSC_VER) || (_MSC_VER >= 1900)
-        ::new(&u.rule_) std::string();
-#endif
-    }
+    // Holds one copy of each distinct transition table of a database.
+    struct detail::transition_registry {
+        struct less {
+            bool
+                operator()(const transition_table* x, const transition_table* y) const {
+                if (x->end != y->end)
+                    return x->end < y->end;
+                return std::lexicographical_compare(
+                    x->transitions.begin(), x->transitions.end(),
+                    y->transitions.begin(), y->transitions.end(),
+                    [](const zone_transition& a, const zone_transition& b) {
+                        return std::tie(a.begin, a.offset, a.save, a.abbrev) <
+                            std::tie(b.begin, b.offset, b.save, b.abbrev);
+                    });
+            }
+        };
 
-    detail::zonelet::zonelet(const zonelet& i)
-        : gmtoff_(i.gmtoff_)
-        , tag_(i.tag_)
-        , format_(i.format_)
-        , until_year_(i.until_year_)
-        , until_date_(i.until_date_)
-        , until_utc_(i.until_utc_)
-        , until_std_(i.until_std_)
-        , until_loc_(i.until_loc_)
-        , initial_save_(i.initial_save_)
-        , initial_abbrev_(i.initial_abbrev_)
-        , first_rule_(i.first_rule_)
-        , last_rule_(i.last_rule_) {
-#if !defined(_MSC_VER) || (_MSC_VER >= 1900)
-        if (tag_ == has_save)
-            ::new(&u.save_) std::chrono::minutes(i.u.save_);
-        else
-            ::new(&u.rule_) std::string(i.u.rule_);
-#else
-        if (tag_ == has_save)
-            u.save_ = i.u.save_;
-        else
-            u.rule_ = i.u.rule_;
-#endif
-    }
+        std::map<const transition_table*, std::shared_ptr<const transition_table>, less> tables;
+    };
 
 #endif  // !USE_OS_TZDB
 
     // time_zone
 
-#if USE_OS_TZDB
+    // Zones are initialized on first use.  A few mutexes shared by all of them
+    // stand in for a once_flag per zone.
+    static
+        std::mutex&
+        init_mutex(const time_zone* z) {
+        static std::mutex mutexes[16];
+        return mutexes[reinterpret_cast<std::uintptr_t>(z) / sizeof(time_zone) % 16];
+    }
 
-    time_zone::time_zone(const std::string& s, detail::undocumented)
-        : name_(s)
-        , adjusted_(new std::once_flag {}) {
+    void
+        time_zone::init() const {
+        if (initialized_.load(std::memory_order_acquire))
+            return;
+        std::lock_guard<std::mutex> lock(init_mutex(this));
+        if (!initialized_.load(std::memory_order_relaxed)) {
+            const_cast<time_zone*>(this)->init_impl();
+            initialized_.store(true, std::memory_order_release);
+        }
     }
 
-    enum class endian {
-        native = __BYTE_ORDER__,
-        little = __ORDER_LITTLE_ENDIAN__,
-        big = __ORDER_BIG_ENDIAN__
-    };
+    // Per-thread cache of the last sys_info handed out for each zone
+
+    namespace {
+
+        // Bumped whenever a time_zone is destroyed or overwritten, so that an
+        // entry keyed on an address that is later reused never reads as a hit.
+        // Entries are keyed on the zone, or on its transition table for times
+        // the table covers, so that zones sharing a table share entries too.
+        std::atomic<std::uint64_t> info_cache_generation {0};
+
+        struct info_cache_entry {
+            const void* key = nullptr;
+            std::uint64_t generation = 0;
+            sys_info info {};
+        };
+
+        struct info_cache {
+            info_cache_entry entries[8];
+            info_cache_stats stats;
+
+            info_cache_entry& slot(const void* key) {
+                auto h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key)) *
+                    UINT64_C(0x9E3779B97F4A7C15);
+                return entries[h >> 61];
+            }
+        };
+
+    }  // unnamed namespace
 
     static
-        inline
-        std::uint32_t
-        reverse_bytes(std::uint32_t i) {
-        return
-            (i & 0xff000000u) >> 24 |
-            (i & 0x00ff0000u) >> 8 |
-            (i & 0x0000ff00u) << 8 |
-            (i & 0x000000ffu) << 24;
+        info_cache&
+        get_info_cache() {
+        thread_local info_cache cache;
+        return cache;
     }
 
+    // Returns the cached interval under key containing tp, or nullptr.
     static
-        inline
-        std::uint64_t
-        reverse_bytes(std::uint64_t i) {
-        return
-            (i & 0xff00000000000000ull) >> 56 |
-            (i & 0x00ff000000000000ull) >> 40 |
-            (i & 0x0000ff0000000000ull) >> 24 |
+        const sys_info*
+        find_cached_info(const void* key, sys_seconds tp) {
+        auto& cache = get_info_cache();
+        auto& e = cache.slot(key);
+        if (e.key == key &&
+            e.generation == info_cache_generation.load(std::memory_order_relaxed) &&
+            e.info.begin <= tp && tp < e.info.end) {
+            ++cache.stats.hits;
+            return &e.info;
+        }
+        ++cache.stats.misses;
+        return nullptr;
+    }
+
+    // Returns the cached interval under key if tp maps uniquely into it.  Offsets of
+    // neighbouring intervals differ by less than a day, so a local time more
+    // than a day from either end of an interval can't belong to any other.
+    static
+        const sys_info*
+        find_cached_info(const void* key, local_seconds tp) {
+        using namespace std::chrono;
+        auto& cache = get_info_cache();
+        auto& e = cache.slot(key);
+        if (e.key == key &&
+            e.generation == info_cache_generation.load(std::memory_order_relaxed)) {
+            auto tps = sys_seconds {(tp - e.info.offset).time_since_epoch()};
+            if (tps - e.info.begin >= days {1} && e.info.end - tps > days {1}) {
+                ++cache.stats.hits;
+                return &e.info;
+            }
+        }
+        ++cache.stats.misses;
+        return nullptr;
+    }
+
+    static
+        void
+        cache_info(const void* key, const sys_info& info) {
+        auto& e = get_info_cache().slot(key);
+        e.key = key;
+        e.generation = info_cache_generation.load(std::memory_order_relaxed);
+        e.info = info;
+    }
+
+    static
+        void
+        cache_info(const void* key, const local_info& info) {
+        if (info.result == local_info::unique)
+            cache_info(key, info.first);
+    }
+
+    info_cache_stats
+        get_info_cache_stats() NOEXCEPT {
+        return get_info_cache().stats;
+    }
+
+    void
+        reset_info_cache_stats() NOEXCEPT {
+        get_info_cache().stats = info_cache_stats {};
+    }
+
+    time_zone::~time_zone() {
+        info_cache_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    time_zone::time_zone(time_zone&& src)
+        : name_(std::move(src.name_))
+#if USE_OS_TZDB
+        , transitions_(std::move(src.transitions_))
+        , ttinfos_(std::move(src.ttinfos_))
+        , footer_(std::move(src.footer_))
+        , footer_begin_(src.footer_begin_)
+#else  // !USE_OS_TZDB
+        , zonelets_(std::move(src.zonelets_))
+        , zonelet_abbrevs_(std::move(src.zonelet_abbrevs_))
+        , table_(std::move(src.table_))
+        , recurring_(std::move(src.recurring_))
+        , fixed_(src.fixed_)
+        , mapped_(src.mapped_)
+        , abbrevs_(src.abbrevs_)
+        , rules_(src.rules_)
+        , strings_(src.strings_)
+#endif  // !USE_OS_TZDB
+        , initialized_(src.initialized_.load(std::memory_order_relaxed)) {
+    }
+
+#if !USE_OS_TZDB
+    // Locked against src being initialized meanwhile.  The zonelets refer to
+    // rules by their place among those of the same name, which is the same in
+    // the tzdb this is copied into.
+    time_zone::time_zone(const time_zone& src, detail::undocumented) {
+        std::lock_guard<std::mutex> lock(init_mutex(&src));
+        name_ = src.name_;
+        zonelets_ = src.zonelets_;
+        zonelet_abbrevs_ = src.zonelet_abbrevs_;
+        table_ = src.table_;
+        recurring_ = src.recurring_;
+        fixed_ = src.fixed_;
+        mapped_ = src.mapped_;
+        rules_ = src.rules_;
+        strings_ = src.strings_;
+        initialized_.store(src.initialized_.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+#endif  // !USE_OS_TZDB
+
+    time_zone&
+        time_zone::operator=(time_zone&& src) {
+        info_cache_generation.fetch_add(1, std::memory_order_relaxed);
+        name_ = std::move(src.name_);
+#if USE_OS_TZDB
+        transitions_ = std::move(src.transitions_);
+        ttinfos_ = std::move(src.ttinfos_);
+        footer_ = std::move(src.footer_);
+        footer_begin_ = src.footer_begin_;
+#else  // !USE_OS_TZDB
+        zonelets_ = std::move(src.zonelets_);
+        zonelet_abbrevs_ = std::move(src.zonelet_abbrevs_);
+        table_ = std::move(src.table_);
+        recurring_ = std::move(src.recurring_);
+        fixed_ = src.fixed_;
+        mapped_ = src.mapped_;
+        abbrevs_ = src.abbrevs_;
+        rules_ = src.rules_;
+        strings_ = src.strings_;
+#endif  // !USE_OS_TZDB
+        initialized_.store(src.initialized_.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+        return *this;
+    }
+
+    // Whether the year of tp is inside of [min_year, max_year]
+    static
+        bool
+        in_year_range(sys_seconds tp) {
+        using namespace date;
+        return sys_days(min_year / min_day) <= tp && tp < sys_days(max_year / max_day) + days {1};
+    }
+
+    // Times whose year is outside of [min_year, max_year] are refused up front,
+    // so that bad input costs a comparison instead of an exception.  So are
+    // local times within a day of either end, which may map outside of them.
+    tz_status
+        time_zone::try_get_info_impl(sys_seconds tp, sys_info& info) const NOEXCEPT {
+        if (!in_year_range(tp))
+            return tz_status::out_of_range;
+        try {
+            info = get_info_impl(tp);
+            return tz_status::ok;
+        } catch (...) {
+            return tz_status::unavailable;
+        }
+    }
+
+    tz_status
+        time_zone::try_get_info_impl(local_seconds tp, local_info& info) const NOEXCEPT {
+        using namespace date;
+        if (tp < local_days(min_year / min_day) + days {1} ||
+            tp >= local_days(max_year / max_day))
+            return tz_status::out_of_range;
+        try {
+            info = get_info_impl(tp);
+            return tz_status::ok;
+        } catch (...) {
+            return tz_status::unavailable;
+        }
+    }
+
+    void
+        time_zone::to_local_batch(const sys_seconds* tp, std::size_t n,
+            local_seconds* out) const {
+        std::chrono::seconds offsets[256];
+        while (n != 0) {
+            auto m = std::min<std::size_t>(n, 256);
+            get_offsets(tp, m, offsets);
+            for (std::size_t j = 0; j < m; ++j)
+                out[j] = local_seconds {(tp[j] + offsets[j]).time_since_epoch()};
+            tp += m;
+            out += m;
+            n -= m;
+        }
+    }
+
+    namespace {
+
+        // The parts of a sys_info that to_sys_batch needs
+        struct offset_interval {
+            sys_seconds begin;
+            sys_seconds end;
+            std::chrono::seconds offset;
+        };
+
+    }  // unnamed namespace
+
+    static
+        offset_interval
+        make_offset_interval(const sys_info& i) {
+        return {i.begin, i.end, i.offset};
+    }
+
+    // Maps tp to sys time given how it looked up, as to_sys does, except that
+    // policy decides the ambiguous and nonexistent cases.
+    static
+        sys_seconds
+        resolve_local(local_seconds tp, to_sys_status result, const offset_interval& first,
+            const offset_interval& second, to_sys_policy policy) {
+        auto tps = sys_seconds {tp.time_since_epoch()};
+        if (result == to_sys_status::unique)
+            return tps - first.offset;
+        if (policy == to_sys_policy::flag)
+            return sys_seconds::min();
+        if (result == to_sys_status::nonexistent)
+            return policy == to_sys_policy::shift_forward ? tps - first.offset : first.end;
+        return policy == to_sys_policy::latest ? tps - second.offset : tps - first.offset;
+    }
+
+    // The contents of a whole file in memory, released on destruction.  Files
+    // of map_threshold bytes or more are mapped.  Zoneinfo files are a few KB,
+    // and for those one read into a buffer is cheaper than setting up and
+    // tearing down a mapping.  Like an ifstream, a file that can't be read is
+    // reported by is_open().
+    class mapped_file {
+        const unsigned char*             data_ = nullptr;
+        std::size_t                      size_ = 0;
+        bool                             mapped_ = false;
+        bool                             open_ = false;
+        bool                             private_ = true;
+        std::unique_ptr<unsigned char[]> buffer_;
+
+    public:
+#ifdef _WIN32
+        explicit mapped_file(const std::string& name, std::size_t = 0) {
+            auto file = ::CreateFileA(name.c_str(), GENERIC_READ,
+                FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return;
+            LARGE_INTEGER size;
+            if (::GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+                auto mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                    nullptr);
+                if (mapping != nullptr) {
+                    auto p = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    if (p != nullptr) {
+                        data_ = static_cast<const unsigned char*>(p);
+                        size_ = static_cast<std::size_t>(size.QuadPart);
+                        mapped_ = open_ = true;
+                    }
+                    ::CloseHandle(mapping);
+                }
+            }
+            ::CloseHandle(file);
+        }
+
+        ~mapped_file() {
+            if (mapped_)
+                ::UnmapViewOfFile(data_);
+        }
+#else  // !_WIN32
+        explicit mapped_file(const std::string& name, std::size_t map_threshold = 64 * 1024) {
+            int fd = ::open(name.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return;
+            struct stat st;
+            if (::fstat(fd, &st) == 0) {
+                private_ = st.st_uid == ::geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+                size_ = static_cast<std::size_t>(st.st_size);
+                if (size_ >= map_threshold) {
+                    auto p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED) {
+                        data_ = static_cast<const unsigned char*>(p);
+                        mapped_ = open_ = true;
+                    }
+                } else {
+                    buffer_.reset(new unsigned char[size_ + 1]);
+                    std::size_t n = 0;
+                    ssize_t r = 0;
+                    while (n < size_ && (r = ::read(fd, buffer_.get() + n, size_ - n)) > 0)
+                        n += static_cast<std::size_t>(r);
+                    if (r >= 0) {
+                        data_ = buffer_.get();
+                        size_ = n;
+                        open_ = true;
+                    }
+                }
+            }
+            ::close(fd);
+        }
+
+        ~mapped_file() {
+            if (mapped_)
+                ::munmap(const_cast<unsigned char*>(data_), size_);
+        }
+#endif  // !_WIN32
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        bool is_open() const {return open_;}
+        // Whether the file belongs to this user and no one else can write to it.
+        // Always true on Windows.
+        bool is_private() const {return private_;}
+        const unsigned char* data() const {return data_;}
+        std::size_t size() const {return size_;}
+    };
+
+#if USE_OS_TZDB
+
+    time_zone::time_zone(const std::string& s, detail::undocumented)
+        : name_(s) {
+    }
+
+    enum class endian {
+        native = __BYTE_ORDER__,
+        little = __ORDER_LITTLE_ENDIAN__,
+        big = __ORDER_BIG_ENDIAN__
+    };
+
+    static
+        inline
+        std::uint32_t
+        reverse_bytes(std::uint32_t i) {
+        return
+            (i & 0xff000000u) >> 24 |
+            (i & 0x00ff0000u) >> 8 |
+            (i & 0x0000ff00u) << 8 |
+            (i & 0x000000ffu) << 24;
+    }
+
+    static
+        inline
+        std::uint64_t
+        reverse_bytes(std::uint64_t i) {
+        return
+            (i & 0xff00000000000000ull) >> 56 |
+            (i & 0x00ff000000000000ull) >> 40 |
+            (i & 0x0000ff0000000000ull) >> 24 |
             (i & 0x000000ff00000000ull) >> 8 |
             (i & 0x00000000ff000000ull) << 8 |
             (i & 0x0000000000ff0000ull) << 24 |
@@ -1622,138 +2412,167 @@ namespace date {
             endian::native == endian::little>{});
     }
 
+    // Walks a TZif image in memory.  Running off the end throws, as reading
+    // past the end of the stream used to.
+    struct tzif_reader {
+        const unsigned char* p;
+        const unsigned char* end;
+
+        const unsigned char*
+            take(std::size_t n) {
+            if (static_cast<std::size_t>(end - p) < n)
+                throw std::runtime_error("Truncated TZif data");
+            auto r = p;
+            p += n;
+            return r;
+        }
+    };
+
+    template <class T>
+    static
+        inline
+        T
+        load_big_endian(const unsigned char* p) {
+        T t;
+        std::memcpy(&t, p, sizeof(t));
+        maybe_reverse_bytes(t);
+        return t;
+    }
+
+    // Converts n big-endian values at p into out.  A plain loop over a copy,
+    // so that the compiler turns it into vector byte shuffles.
+    template <class T>
+    static
+        void
+        load_big_endian(const unsigned char* p, std::size_t n, T* out) {
+        std::memcpy(out, p, n * sizeof(T));
+        for (std::size_t i = 0; i < n; ++i)
+            maybe_reverse_bytes(out[i]);
+    }
+
     static
         void
-        load_header(std::istream& inf) {
+        load_header(tzif_reader& in) {
         // Read TZif
-        auto t = inf.get();
-        auto z = inf.get();
-        auto i = inf.get();
-        auto f = inf.get();
+        auto p = in.take(4);
 #ifndef NDEBUG
-        assert(t == 'T');
-        assert(z == 'Z');
-        assert(i == 'i');
-        assert(f == 'f');
+        assert(std::memcmp(p, "TZif", 4) == 0);
 #else
-        (void)t;
-        (void)z;
-        (void)i;
-        (void)f;
+        (void)p;
 #endif
     }
 
     static
         unsigned char
-        load_version(std::istream& inf) {
+        load_version(tzif_reader& in) {
         // Read version
-        auto v = inf.get();
-        assert(v != EOF);
-        return static_cast<unsigned char>(v);
+        return *in.take(1);
     }
 
     static
         void
-        skip_reserve(std::istream& inf) {
-        inf.ignore(15);
+        skip_reserve(tzif_reader& in) {
+        in.take(15);
     }
 
     static
         void
-        load_counts(std::istream& inf,
+        load_counts(tzif_reader& in,
             std::int32_t& tzh_ttisgmtcnt, std::int32_t& tzh_ttisstdcnt,
             std::int32_t& tzh_leapcnt, std::int32_t& tzh_timecnt,
             std::int32_t& tzh_typecnt, std::int32_t& tzh_charcnt) {
         // Read counts;
-        inf.read(reinterpret_cast<char*>(&tzh_ttisgmtcnt), 4);
-        maybe_reverse_bytes(tzh_ttisgmtcnt);
-        inf.read(reinterpret_cast<char*>(&tzh_ttisstdcnt), 4);
-        maybe_reverse_bytes(tzh_ttisstdcnt);
-        inf.read(reinterpret_cast<char*>(&tzh_leapcnt), 4);
-        maybe_reverse_bytes(tzh_leapcnt);
-        inf.read(reinterpret_cast<char*>(&tzh_timecnt), 4);
-        maybe_reverse_bytes(tzh_timecnt);
-        inf.read(reinterpret_cast<char*>(&tzh_typecnt), 4);
-        maybe_reverse_bytes(tzh_typecnt);
-        inf.read(reinterpret_cast<char*>(&tzh_charcnt), 4);
-        maybe_reverse_bytes(tzh_charcnt);
-    }
-
+        std::int32_t counts[6];
+        load_big_endian(in.take(sizeof(counts)), 6, counts);
+        tzh_ttisgmtcnt = counts[0];
+        tzh_ttisstdcnt = counts[1];
+        tzh_leapcnt = counts[2];
+        tzh_timecnt = counts[3];
+        tzh_typecnt = counts[4];
+        tzh_charcnt = counts[5];
+    }
+
+    // Size of the data block that follows the counts.  Negative counts give
+    // sizes no file has, so take() rejects them.
     template <class TimeType>
     static
-        std::vector<detail::transition>
-        load_transitions(std::istream& inf, std::int32_t tzh_timecnt) {
-        // Read transitions
-        using namespace std::chrono;
-        std::vector<detail::transition> transitions;
-        transitions.reserve(static_cast<unsigned>(tzh_timecnt));
-        for (std::int32_t i = 0; i < tzh_timecnt; ++i) {
-            TimeType t;
-            inf.read(reinterpret_cast<char*>(&t), sizeof(t));
-            maybe_reverse_bytes(t);
-            transitions.emplace_back(sys_seconds {seconds{t}});
-            if (transitions.back().timepoint < min_seconds)
-                transitions.back().timepoint = min_seconds;
-        }
-        return transitions;
-    }
-
-    static
-        std::vector<std::uint8_t>
-        load_indices(std::istream& inf, std::int32_t tzh_timecnt) {
-        // Read indices
-        std::vector<std::uint8_t> indices;
-        indices.reserve(static_cast<unsigned>(tzh_timecnt));
-        for (std::int32_t i = 0; i < tzh_timecnt; ++i) {
-            std::uint8_t t;
-            inf.read(reinterpret_cast<char*>(&t), sizeof(t));
-            indices.emplace_back(t);
-        }
-        return indices;
+        std::size_t
+        data_size(std::int32_t tzh_ttisgmtcnt, std::int32_t tzh_ttisstdcnt,
+            std::int32_t tzh_leapcnt, std::int32_t tzh_timecnt,
+            std::int32_t tzh_typecnt, std::int32_t tzh_charcnt) {
+        auto n = [](std::int32_t c) {return static_cast<std::size_t>(static_cast<std::uint32_t>(c));};
+        return (sizeof(TimeType) + 1) * n(tzh_timecnt) + 6 * n(tzh_typecnt) + n(tzh_charcnt) +
+            (sizeof(TimeType) + 4) * n(tzh_leapcnt) + n(tzh_ttisstdcnt) + n(tzh_ttisgmtcnt);
     }
 
+    // Reads the header and counts of the block with the data in seconds of
+    // the widest type the file has, and returns that block.  The first is
+    // skipped if a second follows it.
     static
-        std::vector<ttinfo>
-        load_ttinfo(std::istream& inf, std::int32_t tzh_typecnt) {
-        // Read ttinfo
-        std::vector<ttinfo> ttinfos;
-        ttinfos.reserve(static_cast<unsigned>(tzh_typecnt));
-        for (std::int32_t i = 0; i < tzh_typecnt; ++i) {
-            ttinfo t;
-            inf.read(reinterpret_cast<char*>(&t), 6);
-            maybe_reverse_bytes(t.tt_gmtoff);
-            ttinfos.emplace_back(t);
-        }
-        return ttinfos;
+        const unsigned char*
+        load_data_block(tzif_reader& in, bool& wide,
+            std::int32_t& tzh_ttisgmtcnt, std::int32_t& tzh_ttisstdcnt,
+            std::int32_t& tzh_leapcnt, std::int32_t& tzh_timecnt,
+            std::int32_t& tzh_typecnt, std::int32_t& tzh_charcnt) {
+        load_header(in);
+        auto v = load_version(in);
+        skip_reserve(in);
+        load_counts(in, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
+            tzh_timecnt, tzh_typecnt, tzh_charcnt);
+        wide = v != 0;
+        if (!wide)
+            return in.take(data_size<std::int32_t>(tzh_ttisgmtcnt, tzh_ttisstdcnt,
+                tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt));
+        in.take(data_size<std::int32_t>(tzh_ttisgmtcnt, tzh_ttisstdcnt,
+            tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt));
+        load_header(in);
+        auto v2 = load_version(in);
+        assert(v == v2);
+        (void)v2;
+        skip_reserve(in);
+        load_counts(in, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
+            tzh_timecnt, tzh_typecnt, tzh_charcnt);
+        return in.take(data_size<std::int64_t>(tzh_ttisgmtcnt, tzh_ttisstdcnt,
+            tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt));
     }
 
+    // Reads the POSIX TZ string that follows the data of a version 2+ file,
+    // or returns an empty string.
     static
         std::string
-        load_abbreviations(std::istream& inf, std::int32_t tzh_charcnt) {
-        // Read abbreviations
-        std::string abbrev;
-        abbrev.resize(static_cast<unsigned>(tzh_charcnt), '\0');
-        inf.read(&abbrev[0], tzh_charcnt);
-        return abbrev;
-    }
+        load_footer(tzif_reader& in) {
+        if (in.p == in.end || *in.p != '\n')
+            return {};
+        auto b = in.p + 1;
+        auto e = std::find(b, in.end, '\n');
+        if (e == in.end)
+            return {};
+        in.p = e + 1;
+        return std::string(b, e);
+    }
+
+    // The rule of a POSIX TZ string, as used past the explicit transitions,
+    // with its abbreviations kept for get_abbrev
+    struct detail::posix_footer {
+        Posix::time_zone rule;
+        std::string      std_abbrev;
+        std::string      dst_abbrev;
+    };
 
 #if !MISSING_LEAP_SECONDS
 
     template <class TimeType>
     static
         std::vector<leap_second>
-        load_leaps(std::istream& inf, std::int32_t tzh_leapcnt) {
+        load_leaps(const unsigned char* p, std::int32_t tzh_leapcnt) {
         // Read tzh_leapcnt pairs
         using namespace std::chrono;
         std::vector<leap_second> leap_seconds;
         leap_seconds.reserve(static_cast<std::size_t>(tzh_leapcnt));
         for (std::int32_t i = 0; i < tzh_leapcnt; ++i) {
-            TimeType     t0;
-            std::int32_t t1;
-            inf.read(reinterpret_cast<char*>(&t0), sizeof(t0));
-            inf.read(reinterpret_cast<char*>(&t1), sizeof(t1));
-            maybe_reverse_bytes(t0);
-            maybe_reverse_bytes(t1);
+            auto t0 = load_big_endian<TimeType>(p);
+            auto t1 = load_big_endian<std::int32_t>(p + sizeof(TimeType));
+            p += sizeof(TimeType) + 4;
             leap_seconds.emplace_back(sys_seconds {seconds{t0 - (t1 - 1)}},
                 detail::undocumented {});
         }
@@ -1763,81 +2582,81 @@ namespace date {
     template <class TimeType>
     static
         std::vector<leap_second>
-        load_leap_data(std::istream& inf,
+        load_leap_data(const unsigned char* p,
             std::int32_t tzh_leapcnt, std::int32_t tzh_timecnt,
             std::int32_t tzh_typecnt, std::int32_t tzh_charcnt) {
-        inf.ignore(tzh_timecnt * static_cast<std::int32_t>(sizeof(TimeType)) + tzh_timecnt +
-            tzh_typecnt * 6 + tzh_charcnt);
-        return load_leaps<TimeType>(inf, tzh_leapcnt);
+        return load_leaps<TimeType>(p + (sizeof(TimeType) + 1) * tzh_timecnt +
+            6 * tzh_typecnt + tzh_charcnt, tzh_leapcnt);
     }
 
     static
         std::vector<leap_second>
-        load_just_leaps(std::istream& inf) {
-        // Read tzh_leapcnt pairs
-        using namespace std::chrono;
-        load_header(inf);
-        auto v = load_version(inf);
+        load_just_leaps(const mapped_file& file) {
+        tzif_reader in {file.data(), file.data() + file.size()};
+        bool wide;
         std::int32_t tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
             tzh_timecnt, tzh_typecnt, tzh_charcnt;
-        skip_reserve(inf);
-        load_counts(inf, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
+        auto p = load_data_block(in, wide, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
             tzh_timecnt, tzh_typecnt, tzh_charcnt);
-        if (v == 0)
-            return load_leap_data<int32_t>(inf, tzh_leapcnt, tzh_timecnt, tzh_typecnt,
+        if (!wide)
+            return load_leap_data<std::int32_t>(p, tzh_leapcnt, tzh_timecnt, tzh_typecnt,
                 tzh_charcnt);
-#if !defined(NDEBUG)
-        inf.ignore((4 + 1) * tzh_timecnt + 6 * tzh_typecnt + tzh_charcnt + 8 * tzh_leapcnt +
-            tzh_ttisstdcnt + tzh_ttisgmtcnt);
-        load_header(inf);
-        auto v2 = load_version(inf);
-        assert(v == v2);
-        skip_reserve(inf);
-#else  // defined(NDEBUG)
-        inf.ignore((4 + 1) * tzh_timecnt + 6 * tzh_typecnt + tzh_charcnt + 8 * tzh_leapcnt +
-            tzh_ttisstdcnt + tzh_ttisgmtcnt + (4 + 1 + 15));
-#endif  // defined(NDEBUG)
-        load_counts(inf, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
-            tzh_timecnt, tzh_typecnt, tzh_charcnt);
-        return load_leap_data<int64_t>(inf, tzh_leapcnt, tzh_timecnt, tzh_typecnt,
+        return load_leap_data<std::int64_t>(p, tzh_leapcnt, tzh_timecnt, tzh_typecnt,
             tzh_charcnt);
     }
 
 #endif  // !MISSING_LEAP_SECONDS
 
+    // p is a data block whose size has been checked against the counts
     template <class TimeType>
     void
-        time_zone::load_data(std::istream& inf,
+        time_zone::load_data(const unsigned char* p,
             std::int32_t tzh_leapcnt, std::int32_t tzh_timecnt,
             std::int32_t tzh_typecnt, std::int32_t tzh_charcnt) {
         using namespace std::chrono;
-        transitions_ = load_transitions<TimeType>(inf, tzh_timecnt);
-        auto indices = load_indices(inf, tzh_timecnt);
-        auto infos = load_ttinfo(inf, tzh_typecnt);
-        auto abbrev = load_abbreviations(inf, tzh_charcnt);
+        auto timecnt = static_cast<std::size_t>(tzh_timecnt);
+        auto typecnt = static_cast<std::size_t>(tzh_typecnt);
+        auto times = p;
+        auto indices = times + sizeof(TimeType) * timecnt;
+        auto infos = indices + timecnt;
+        auto abbrev = reinterpret_cast<const char*>(infos + 6 * typecnt);
+        auto abbrev_end = abbrev + tzh_charcnt;
+        ttinfos_.reserve(typecnt);
+        for (std::size_t i = 0; i < typecnt; ++i) {
+            auto info = infos + 6 * i;
+            auto a = abbrev + std::min<std::size_t>(info[5], tzh_charcnt);
+            ttinfos_.push_back({seconds{load_big_endian<std::int32_t>(info)},
+                                std::string(a, std::find(a, abbrev_end, '\0')),
+                                info[4] != 0});
+        }
 #if !MISSING_LEAP_SECONDS
         auto& leap_seconds = get_tzdb_list().front().leap_seconds;
         if (leap_seconds.empty() && tzh_leapcnt > 0)
-            leap_seconds = load_leaps<TimeType>(inf, tzh_leapcnt);
+            leap_seconds = load_leaps<TimeType>(reinterpret_cast<const unsigned char*>(abbrev_end),
+                tzh_leapcnt);
 #endif
-        ttinfos_.reserve(infos.size());
-        for (auto& info : infos) {
-            ttinfos_.push_back({seconds{info.tt_gmtoff},
-                                abbrev.c_str() + info.tt_abbrind,
-                                info.tt_isdst != 0});
-        }
-        auto i = 0u;
-        if (transitions_.empty() || transitions_.front().timepoint != min_seconds) {
-            transitions_.emplace(transitions_.begin(), min_seconds);
+        // Times before min_seconds are clamped to it.  Unless the first one
+        // lands there, an entry for the standard time before it comes first.
+        transitions_.reserve(timecnt + 1);
+        if (timecnt == 0 || load_big_endian<TimeType>(times) > min_seconds.time_since_epoch().count()) {
             auto tf = std::find_if(ttinfos_.begin(), ttinfos_.end(),
                 [](const expanded_ttinfo& ti) {return ti.is_dst == 0; });
             if (tf == ttinfos_.end())
                 tf = ttinfos_.begin();
-            transitions_[i].info = &*tf;
-            ++i;
+            transitions_.emplace_back(min_seconds);
+            transitions_.back().info = &*tf;
+        }
+        TimeType buf[256];
+        for (std::size_t i = 0; i < timecnt; i += 256) {
+            auto n = std::min<std::size_t>(timecnt - i, 256);
+            load_big_endian(times + sizeof(TimeType) * i, n, buf);
+            for (std::size_t j = 0; j < n; ++j) {
+                if (indices[i + j] >= typecnt)
+                    throw std::runtime_error("Invalid TZif type index in " + name_);
+                transitions_.emplace_back(std::max(sys_seconds {seconds{buf[j]}}, min_seconds));
+                transitions_.back().info = ttinfos_.data() + indices[i + j];
+            }
         }
-        for (auto j = 0u; i < transitions_.size(); ++i, ++j)
-            transitions_[i].info = ttinfos_.data() + indices[j];
     }
 
     void
@@ -1845,34 +2664,21 @@ namespace date {
         using namespace std;
         using namespace std::chrono;
         auto name = get_tz_dir() + ('/' + name_);
-        std::ifstream inf(name);
-        if (!inf.is_open())
+        mapped_file file(name);
+        if (!file.is_open())
             throw std::runtime_error {"Unable to open " + name};
-        inf.exceptions(std::ios::failbit | std::ios::badbit);
-        load_header(inf);
-        auto v = load_version(inf);
+        tzif_reader in {file.data(), file.data() + file.size()};
+        bool wide;
         std::int32_t tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
             tzh_timecnt, tzh_typecnt, tzh_charcnt;
-        skip_reserve(inf);
-        load_counts(inf, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
+        auto p = load_data_block(in, wide, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
             tzh_timecnt, tzh_typecnt, tzh_charcnt);
-        if (v == 0) {
-            load_data<int32_t>(inf, tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt);
+        std::string footer;
+        if (!wide) {
+            load_data<int32_t>(p, tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt);
         } else {
-#if !defined(NDEBUG)
-            inf.ignore((4 + 1) * tzh_timecnt + 6 * tzh_typecnt + tzh_charcnt + 8 * tzh_leapcnt +
-                tzh_ttisstdcnt + tzh_ttisgmtcnt);
-            load_header(inf);
-            auto v2 = load_version(inf);
-            assert(v == v2);
-            skip_reserve(inf);
-#else  // defined(NDEBUG)
-            inf.ignore((4 + 1) * tzh_timecnt + 6 * tzh_typecnt + tzh_charcnt + 8 * tzh_leapcnt +
-                tzh_ttisstdcnt + tzh_ttisgmtcnt + (4 + 1 + 15));
-#endif  // defined(NDEBUG)
-            load_counts(inf, tzh_ttisgmtcnt, tzh_ttisstdcnt, tzh_leapcnt,
-                tzh_timecnt, tzh_typecnt, tzh_charcnt);
-            load_data<int64_t>(inf, tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt);
+            load_data<int64_t>(p, tzh_leapcnt, tzh_timecnt, tzh_typecnt, tzh_charcnt);
+            footer = load_footer(in);
         }
 #if !MISSING_LEAP_SECONDS
         if (tzh_leapcnt > 0) {
@@ -1906,11 +2712,114 @@ namespace date {
                     i = transitions_.erase(i);
             }
         }
+        attach_footer(footer);
     }
 
+    // Hands the times past the explicit transitions to the rule of the POSIX
+    // TZ string s.  Trailing transitions that the rule makes itself are
+    // dropped, so a "fat" file keeps no more of them than a "slim" one does.
     void
-        time_zone::init() const {
-        std::call_once(*adjusted_, [this]() {const_cast<time_zone*>(this)->init_impl(); });
+        time_zone::attach_footer(const std::string& s) {
+        using namespace std::chrono;
+        if (s.empty() || transitions_.empty())
+            return;
+        std::unique_ptr<detail::posix_footer> f;
+        try {
+            f.reset(new detail::posix_footer {Posix::time_zone {s}, {}, {}});
+        } catch (const std::exception&) {
+            // Not understood:  the last transition stays in effect for good
+            return;
+        }
+        auto same = [](const sys_info& x, const expanded_ttinfo& y) {
+            return x.offset == y.offset && x.abbrev == y.abbrev &&
+                (x.save != minutes {0}) == y.is_dst;
+        };
+        auto const& last = transitions_.back();
+        auto info = f->rule.get_info(last.timepoint);
+        // A constant offset adds nothing, and a rule that disagrees with the
+        // table isn't trusted.
+        if (info.begin == sys_days(min_year / min_day) || !same(info, *last.info))
+            return;
+        auto next = f->rule.get_info(info.end);
+        (info.save != minutes {0} ? f->dst_abbrev : f->std_abbrev) = info.abbrev;
+        (next.save != minutes {0} ? f->dst_abbrev : f->std_abbrev) = next.abbrev;
+        footer_begin_ = info.end;
+        while (transitions_.size() > 1) {
+            auto const& t = transitions_.back();
+            auto const& before = *transitions_[transitions_.size() - 2].info;
+            auto i = f->rule.get_info(t.timepoint);
+            if (i.begin != t.timepoint || i.end != footer_begin_ || !same(i, *t.info) ||
+                !same(f->rule.get_info(t.timepoint - seconds {1}), before))
+                break;
+            footer_begin_ = t.timepoint;
+            transitions_.pop_back();
+        }
+        transitions_.shrink_to_fit();
+        footer_ = std::move(f);
+    }
+
+    // The interval of the footer rule containing tp, which is at or after
+    // footer_begin_
+    sys_info
+        time_zone::footer_info(sys_seconds tp) const {
+        using namespace std::chrono;
+        auto r = footer_->rule.get_info(tp);
+        r.begin = std::max(r.begin, footer_begin_);
+        // As for the table, save only tells daylight saving time apart
+        r.save = r.save != minutes {0} ? minutes {1} : minutes {0};
+        return r;
+    }
+
+    sys_info
+        time_zone::info_at(sys_seconds tp) const {
+        if (tp >= footer_begin_)
+            return footer_info(tp);
+        return load_sys_info(find_transition(tp));
+    }
+
+    // For local times within a day of footer_begin_ or past it.  There is no
+    // table to search there, so the intervals around tp are visited in turn.
+    local_info
+        time_zone::footer_local_info(local_seconds tp) const {
+        using namespace std::chrono;
+        auto tpl = sys_seconds {tp.time_since_epoch()};
+        auto contains = [tpl](const sys_info& x) {
+            auto tps = tpl - x.offset;
+            return x.begin <= tps && tps < x.end;
+        };
+        local_info r {};
+        auto x = info_at(tpl - info_at(tpl).offset);
+        if (!contains(x)) {
+            bool earlier = tpl - x.offset < x.begin;
+            auto y = earlier ? info_at(x.begin - seconds {1}) : info_at(x.end);
+            if (!contains(y)) {
+                r.result = local_info::nonexistent;
+                r.first = earlier ? std::move(y) : std::move(x);
+                r.second = earlier ? std::move(x) : std::move(y);
+                return r;
+            }
+            x = std::move(y);
+        }
+        auto tps = tpl - x.offset;
+        if (tps < x.begin + days {1} && x.begin != transitions_.front().timepoint) {
+            auto y = info_at(x.begin - seconds {1});
+            if (contains(y)) {
+                r.result = local_info::ambiguous;
+                r.first = std::move(y);
+                r.second = std::move(x);
+                return r;
+            }
+        } else if (x.end - tps <= days {1}) {
+            auto y = info_at(x.end);
+            if (contains(y)) {
+                r.result = local_info::ambiguous;
+                r.first = std::move(x);
+                r.second = std::move(y);
+                return r;
+            }
+        }
+        r.first = std::move(x);
+        return r;
     }
 
     sys_info
@@ -1920,35 +2829,199 @@ namespace date {
         assert(i != transitions_.begin());
         sys_info r;
         r.begin = i[-1].timepoint;
-        r.end = i != transitions_.end() ? i->timepoint :
-            sys_seconds(sys_days(year::max() / max_day));
+        if (i != transitions_.end())
+            r.end = i->timepoint;
+        else if (footer_ != nullptr)
+            r.end = footer_begin_;
+        else
+            r.end = sys_days(year::max() / max_day);
         r.offset = i[-1].info->offset;
         r.save = i[-1].info->is_dst ? minutes {1} : minutes {0};
         r.abbrev = i[-1].info->abbrev;
         return r;
     }
 
+    // Returns the first transition after tp
+    std::vector<detail::transition>::const_iterator
+        time_zone::find_transition(sys_seconds tp) const {
+        return std::upper_bound(transitions_.begin(), transitions_.end(), tp,
+            [](const sys_seconds& x, const transition& t) {
+                return x < t.timepoint;
+            });
+    }
+
+    // Returns the first transition whose local time, measured with the offset
+    // it starts, is after tp
+    std::vector<detail::transition>::const_iterator
+        time_zone::find_local_transition(local_seconds tp) const {
+        return std::upper_bound(transitions_.begin(), transitions_.end(), tp,
+            [](const local_seconds& x, const transition& t) {
+                return sys_seconds {x.time_since_epoch()} -
+                    t.info->offset < t.timepoint;
+            });
+    }
+
     sys_info
         time_zone::get_info_impl(sys_seconds tp) const {
+        if (auto c = find_cached_info(this, tp))
+            return *c;
+        init();
+        auto r = info_at(tp);
+        cache_info(this, r);
+        return r;
+    }
+
+    std::string
+        time_zone::get_abbrev_impl(sys_seconds tp) const {
+        init();
+        if (tp >= footer_begin_)
+            return footer_->rule.get_info(tp).save != std::chrono::minutes {0} ?
+                footer_->dst_abbrev : footer_->std_abbrev;
+        auto i = find_transition(tp);
+        assert(i != transitions_.begin());
+        return i[-1].info->abbrev;
+    }
+
+    std::chrono::seconds
+        time_zone::get_offset_impl(sys_seconds tp) const {
+        init();
+        if (tp >= footer_begin_)
+            return footer_info(tp).offset;
+        auto i = find_transition(tp);
+        assert(i != transitions_.begin());
+        return i[-1].info->offset;
+    }
+
+    std::chrono::seconds
+        time_zone::get_offset_impl(local_seconds tp) const {
+        using namespace std::chrono;
+        init();
+        if (footer_begin_ - days {1} <= sys_seconds {tp.time_since_epoch()})
+            return get_info_impl(tp).first.offset;
+        auto tr = find_local_transition(tp);
+        assert(tr != transitions_.begin());
+        auto offset = tr[-1].info->offset;
+        // Ambiguous times take the earlier interval, as get_info_impl does
+        auto tps = sys_seconds {(tp - offset).time_since_epoch()};
+        if (tps < tr[-1].timepoint + days {1} && tr - 1 != transitions_.begin() &&
+            sys_seconds {(tp - tr[-2].info->offset).time_since_epoch()} < tr[-1].timepoint)
+            return tr[-2].info->offset;
+        return offset;
+    }
+
+    void
+        time_zone::get_offsets(const sys_seconds* tp, std::size_t n,
+            std::chrono::seconds* out) const {
         using namespace std;
         init();
-        return load_sys_info(upper_bound(transitions_.begin(), transitions_.end(), tp,
-            [](const sys_seconds& x, const transition& t) {
-                return x < t.timepoint;
-            }));
+        auto b = transitions_.begin();
+        auto e = transitions_.end();
+        // The current interval is [i[-1].timepoint, i->timepoint)
+        auto i = b;
+        for (std::size_t j = 0; j < n; ++j) {
+            auto t = tp[j];
+            if (t >= footer_begin_) {
+                out[j] = get_info_impl(t).offset;
+                continue;
+            }
+            if (i != b && i != e && t >= i->timepoint) {
+                // Sorted input: step forward a few transitions before searching
+                for (int k = 0; k < 16 && i != e && i->timepoint <= t; ++k)
+                    ++i;
+            }
+            if (i == b || t < i[-1].timepoint || (i != e && t >= i->timepoint)) {
+                i = upper_bound(b, e, t,
+                    [](const sys_seconds& x, const transition& tr) {
+                        return x < tr.timepoint;
+                    });
+                if (i == b) {
+                    out[j] = get_info_impl(t).offset;
+                    continue;
+                }
+            }
+            out[j] = i[-1].info->offset;
+        }
+    }
+
+    void
+        time_zone::to_sys_batch(const local_seconds* tp, std::size_t n, sys_seconds* out,
+            to_sys_status* status, to_sys_policy policy) const {
+        using namespace std::chrono;
+        init();
+        auto b = transitions_.begin();
+        auto e = transitions_.end();
+        auto before = [](const local_seconds& x, const transition& t) {
+            return sys_seconds {x.time_since_epoch()} - t.info->offset < t.timepoint;
+        };
+        auto interval = [&](std::vector<transition>::const_iterator i) {
+            return offset_interval {i[-1].timepoint,
+                i != e ? i->timepoint : footer_ != nullptr ? footer_begin_ :
+                    sys_seconds(sys_days(year::max() / max_day)),
+                i[-1].info->offset};
+        };
+        auto emit = [&](std::size_t j, to_sys_status r, const offset_interval& first,
+            const offset_interval& second) {
+            out[j] = resolve_local(tp[j], r, first, second, policy);
+            if (status != nullptr)
+                status[j] = r;
+        };
+        // i is the upper_bound of the previous element, prev
+        auto i = e;
+        auto prev = local_seconds::max();
+        for (std::size_t j = 0; j < n; ++j) {
+            auto t = tp[j];
+            if (t < prev)
+                i = upper_bound(b, e, t, before);
+            else {
+                // Sorted input: step forward a few transitions before searching
+                for (int k = 0; k < 16 && i != e && !before(t, *i); ++k)
+                    ++i;
+                if (i != e && !before(t, *i))
+                    i = upper_bound(i, e, t, before);
+            }
+            prev = t;
+            auto tpl = sys_seconds {t.time_since_epoch()};
+            if (i == b || footer_begin_ - days {1} <= tpl) {
+                auto li = get_info_impl(t);
+                emit(j, static_cast<to_sys_status>(li.result),
+                    make_offset_interval(li.first), make_offset_interval(li.second));
+                continue;
+            }
+            auto first = interval(i);
+            auto tps = tpl - first.offset;
+            if (tps < first.begin + days {1} && i - 1 != b) {
+                auto p = interval(i - 1);
+                if (tpl - p.offset < p.end)
+                    emit(j, to_sys_status::ambiguous, p, first);
+                else
+                    emit(j, to_sys_status::unique, first, {});
+            } else if (tps >= first.end && i != e) {
+                auto next = interval(i + 1);
+                if (tpl - next.offset < next.begin)
+                    emit(j, to_sys_status::nonexistent, first, next);
+                else
+                    emit(j, to_sys_status::unique, first, {});
+            } else
+                emit(j, to_sys_status::unique, first, {});
+        }
     }
 
     local_info
         time_zone::get_info_impl(local_seconds tp) const {
         using namespace std::chrono;
-        init();
         local_info i;
         i.result = local_info::unique;
-        auto tr = upper_bound(transitions_.begin(), transitions_.end(), tp,
-            [](const local_seconds& x, const transition& t) {
-                return sys_seconds {x.time_since_epoch()} -
-                    t.info->offset < t.timepoint;
-            });
+        if (auto c = find_cached_info(this, tp)) {
+            i.first = *c;
+            return i;
+        }
+        init();
+        if (footer_begin_ - days {1} <= sys_seconds {tp.time_since_epoch()}) {
+            i = footer_local_info(tp);
+            cache_info(this, i);
+            return i;
+        }
+        auto tr = find_local_transition(tp);
         i.first = load_sys_info(tr);
         auto tps = sys_seconds {(tp - i.first.offset).time_since_epoch()};
         if (tps < i.first.begin + days {1} && tr != transitions_.begin()) {
@@ -1968,6 +3041,7 @@ namespace date {
             else
                 i.second = {};
         }
+        cache_info(this, i);
         return i;
     }
 
@@ -1988,6 +3062,8 @@ namespace date {
         os << t.info->abbrev << '\n';
         for (auto i = std::next(z.transitions_.cbegin()); i < z.transitions_.cend(); ++i)
             os << *i << '\n';
+        if (z.footer_ != nullptr)
+            os << "Then by rule:        " << z.footer_->rule << '\n';
         return os;
     }
 
@@ -2001,15 +3077,15 @@ namespace date {
 
 #else  // !USE_OS_TZDB
 
-    time_zone::time_zone(const std::string& s, detail::undocumented)
-        : adjusted_(new std::once_flag {}) {
+    time_zone::time_zone(const std::string& s, detail::string_interner& strings,
+        detail::undocumented) {
         try {
             using namespace date;
             std::istringstream in(s);
             in.exceptions(std::ios::failbit | std::ios::badbit);
             std::string word;
             in >> word >> name_;
-            parse_info(in);
+            parse_info(in, strings);
         } catch (...) {
             std::cerr << s << '\n';
             std::cerr << *this << '\n';
@@ -2018,15 +3094,480 @@ namespace date {
         }
     }
 
-    sys_info
+    // A table mapped from a tzdb image is already in use by lookups inside of
+    // the window, so it is kept as it is.
+    void
+        time_zone::init_impl() {
+        adjust_infos(get_rules(), get_strings());
+        compile_recurring(get_rules());
+        if (!mapped_)
+            build_transitions();
+    }
+
+    // Compiles the rules the last zonelet repeats every year, if they are few
+    // enough and fall in distinct months.  Other zones keep walking the rules.
+    void
+        time_zone::compile_recurring(const std::vector<Rule>& rules) {
+        using namespace std::chrono;
+        using namespace date;
+        recurring_ = nullptr;
+        if (zonelets_.empty())
+            return;
+        auto const& z = zonelets_.back();
+        if (z.tag_ != zonelet::has_rule || z.first_rule_.first == detail::no_rule)
+            return;
+        auto eqr = find_rules(rules, z.u.rule_);
+        auto rr = std::make_shared<detail::recurring_rules>();
+        rr->first_year = year::min();
+        rr->gmtoff = z.gmtoff_;
+        const Rule* prev = nullptr;
+        for (auto r = eqr.first; r != eqr.second; ++r) {
+            if (r->ending_year() != year::max()) {
+                rr->first_year = std::max(rr->first_year, r->ending_year() + years {1});
+                continue;
+            }
+            // split_overlaps leaves the rules that never end with one starting year
+            if (prev != nullptr &&
+                (r->starting_year() != prev->starting_year() ||
+                 r->mdt().month() <= prev->mdt().month()))
+                return;
+            prev = r;
+            if (rr->rules.size() == detail::max_recurring_rules)
+                return;
+            rr->first_year = std::max(rr->first_year, r->starting_year());
+            rr->rules.push_back({r->mdt(), r->save(), r->abbrev_id()});
+        }
+        if (rr->rules.empty())
+            return;
+        if (zonelets_.size() > 1) {
+            auto const& prev_zonelet = zonelets_.end()[-2];
+            rr->first_year = std::max(rr->first_year,
+                year_month_day(floor<days>(prev_zonelet.until_utc_)).year() + years {1});
+        }
+        rr->rules.shrink_to_fit();
+        recurring_ = std::move(rr);
+    }
+
+    namespace {
+
+        // The starts of the recurring rules of one zone in one year
+        struct recurring_year_entry {
+            const detail::recurring_rules* key = nullptr;
+            std::uint64_t generation = 0;
+            date::year y {0};
+            sys_seconds begin[detail::max_recurring_rules];
+        };
+
+    }  // unnamed namespace
+
+    // Returns the start of each of the rules of rr in year y, each measured
+    // with the save of the rule before it, from a small per-thread memo.
+    static
+        const sys_seconds*
+        recurring_year(const detail::recurring_rules& rr, date::year y) {
+        thread_local recurring_year_entry memo[16];
+        auto h = (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&rr)) +
+            static_cast<std::uint64_t>(static_cast<int>(y))) * UINT64_C(0x9E3779B97F4A7C15);
+        auto& e = memo[h >> 60];
+        auto generation = info_cache_generation.load(std::memory_order_relaxed);
+        if (e.key != &rr || e.y != y || e.generation != generation) {
+            auto save = rr.rules.back().save;
+            for (std::size_t k = 0; k < rr.rules.size(); ++k) {
+                e.begin[k] = rr.rules[k].mdt.to_sys(y, rr.gmtoff, save);
+                save = rr.rules[k].save;
+            }
+            e.key = &rr;
+            e.y = y;
+            e.generation = generation;
+        }
+        return e.begin;
+    }
+
+    // Finds the interval containing tp the way find_rule does, but looks only
+    // at the rules of the years around y.  Returns false where the rules before
+    // first_year could still be in effect.
+    static
+        bool
+        find_recurring(const detail::recurring_rules& rr, date::year y, sys_seconds tp,
+            tz timezone, const std::vector<std::string>& strings, sys_info& x) {
+        using namespace std::chrono;
+        using namespace date;
+        if (y < rr.first_year + years {2} || y >= year::max() - years {2})
+            return false;
+        const auto n = rr.rules.size();
+        sys_seconds begin[3 * detail::max_recurring_rules];
+        for (int d = 0; d < 3; ++d)
+            std::copy_n(recurring_year(rr, y + years {d - 1}), n, begin + d * n);
+        auto save_before = [&](std::size_t j) {
+            return rr.rules[(j + 3 * n - 1) % n].save;
+        };
+        // Find the first rule that starts at or after tp, then step back
+        // unless tp is its start
+        std::size_t j = 0;
+        for (; j < 3 * n; ++j) {
+            auto tx = tp;
+            if (timezone == tz::local)
+                tx -= rr.gmtoff + save_before(j);
+            if (tx <= begin[j]) {
+                if (tx < begin[j])
+                    --j;
+                break;
+            }
+        }
+        if (j == static_cast<std::size_t>(-1) || j + 1 >= 3 * n)
+            return false;
+        auto const& r = rr.rules[j % n];
+        x.begin = begin[j];
+        x.end = begin[j + 1];
+        x.save = r.save;
+        x.abbrev = strings[r.letters];
+        return true;
+    }
+
+    // Initializes the zone unless its table is mapped from a tzdb image and
+    // covers tp, and returns whether the table covers tp.
+    bool
+        time_zone::prepare(sys_seconds tp) const {
+        using namespace date;
+        const bool in_window = tp >= sys_days(transition_first_year / min_day) &&
+            tp < sys_days((transition_last_year + years {1}) / min_day);
+        if (!mapped_ || !in_window)
+            init();
+        return in_window && table_ != nullptr;
+    }
+
+    // As above, for the local times find_local_transition looks up in the table
+    bool
+        time_zone::prepare(local_seconds tp) const {
+        using namespace std::chrono;
+        using namespace date;
+        auto tpl = sys_seconds {tp.time_since_epoch()};
+        const bool in_window = tpl - days {1} >= sys_days(transition_first_year / min_day) &&
+            tpl + days {1} < sys_days((transition_last_year + years {1}) / min_day);
+        if (!mapped_ || !in_window)
+            init();
+        return in_window && table_ != nullptr;
+    }
+
+    // Walk the rules once across [transition_first_year, transition_last_year]
+    // and record every interval, so that lookups inside of that window are a
+    // binary search instead of a rule evaluation.
+    void
+        time_zone::build_transitions() {
+        using namespace std::chrono;
+        using namespace date;
+        const sys_seconds first = sys_days(transition_first_year / min_day);
+        const sys_seconds last = sys_days((transition_last_year + years {1}) / min_day);
+        std::vector<detail::zone_transition> table;
+        std::uint16_t abbrev;
+        auto info = get_info_impl(first, static_cast<int>(tz::utc), abbrev);
+        while (true) {
+            // Without an interned abbreviation this zone keeps using the rules
+            if (abbrev == detail::no_abbrev)
+                return;
+            table.push_back({info.begin, static_cast<std::int32_t>(info.offset.count()),
+                static_cast<std::int16_t>(info.save.count()), abbrev});
+            if (info.end >= last)
+                break;
+            info = get_info_impl(info.end, static_cast<int>(tz::utc), abbrev);
+        }
+        if (table.size() > static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()))
+            return;
+        // index[b] is the entry in effect at the start of bucket b
+        std::vector<std::uint16_t> index;
+        index.reserve(static_cast<std::size_t>((last - first) / transition_bucket) + 1);
+        std::size_t k = 0;
+        for (auto t = first; t < last; t += transition_bucket) {
+            while (k + 1 < table.size() && table[k + 1].begin <= t)
+                ++k;
+            index.push_back(static_cast<std::uint16_t>(k));
+        }
+        auto t = std::make_shared<detail::transition_table>();
+        t->transition_storage = std::move(table);
+        t->index_storage = std::move(index);
+        t->transitions = t->transition_storage;
+        t->index = t->index_storage;
+        t->end = info.end;
+        table_ = std::move(t);
+    }
+
+    // True if this zone has a single offset for all time and tp is within it.
+    // Such zones are initialized when the database is loaded.
+    inline
+        bool
+        time_zone::is_fixed_at(sys_seconds tp) const {
+        return fixed_ && table_->transitions.front().begin <= tp && tp < table_->end;
+    }
+
+    // Returns the index of the entry of the table in effect at tp.  tp must
+    // be inside of the table window.
+    std::size_t
+        time_zone::find_transition(sys_seconds tp) const {
+        using namespace date;
+        const sys_seconds first = sys_days(transition_first_year / min_day);
+        auto const& table = *table_;
+        auto b = static_cast<std::size_t>((tp - first) / transition_bucket);
+        assert(b < table.index.size());
+        auto lo = table.transitions.begin() + table.index[b] + 1;
+        auto hi = b + 1 < table.index.size() ?
+            table.transitions.begin() + table.index[b + 1] + 1 : table.transitions.end();
+        auto i = std::upper_bound(lo, hi, tp,
+            [](sys_seconds t, const detail::zone_transition& x) {
+                return t < x.begin;
+            });
+        return static_cast<std::size_t>(i - table.transitions.begin()) - 1;
+    }
+
+    sys_info
+        time_zone::load_sys_info(std::size_t i) const {
+        auto const& table = *table_;
+        assert(i < table.transitions.size());
+        sys_info r;
+        auto const& t = table.transitions[i];
+        r.begin = t.begin;
+        r.end = i + 1 < table.transitions.size() ? table.transitions[i + 1].begin : table.end;
+        r.offset = std::chrono::seconds {t.offset};
+        r.save = std::chrono::minutes {t.save};
+        r.abbrev = abbrevs_[t.abbrev];
+        return r;
+    }
+
+    void
+        time_zone::get_offsets(const sys_seconds* tp, std::size_t n,
+            std::chrono::seconds* out) const {
+        using namespace std::chrono;
+        using namespace date;
+        if (!mapped_)
+            init();
+        auto table = table_.get();
+        const sys_seconds window_begin = sys_days(transition_first_year / min_day);
+        const sys_seconds window_end = sys_days((transition_last_year + years {1}) / min_day);
+        // offset is in effect over [begin, end), which is entry k of the table
+        // if in_table
+        auto begin = sys_seconds::max();
+        auto end = sys_seconds::min();
+        seconds offset {};
+        std::size_t k = 0;
+        bool in_table = false;
+        auto load = [&](std::size_t i) {
+            auto const& x = table->transitions[i];
+            k = i;
+            begin = x.begin;
+            end = i + 1 < table->transitions.size() ? table->transitions[i + 1].begin : table->end;
+            offset = seconds {x.offset};
+            in_table = true;
+        };
+        for (std::size_t j = 0; j < n; ++j) {
+            auto t = tp[j];
+            if (in_table && t >= end) {
+                // Sorted input: step forward a few transitions before searching
+                auto i = k;
+                for (int s = 0; s < 16 && i + 1 < table->transitions.size() &&
+                     table->transitions[i + 1].begin <= t; ++s)
+                    ++i;
+                load(i);
+            }
+            if (t < begin || t >= end) {
+                if (table && window_begin <= t && t < window_end)
+                    load(find_transition(t));
+                else {
+                    auto info = get_info_impl(t);
+                    begin = info.begin;
+                    end = info.end;
+                    offset = info.offset;
+                    in_table = false;
+                }
+            }
+            out[j] = offset;
+        }
+    }
+
+    void
+        time_zone::to_sys_batch(const local_seconds* tp, std::size_t n, sys_seconds* out,
+            to_sys_status* status, to_sys_policy policy) const {
+        using namespace std::chrono;
+        using namespace date;
+        if (!mapped_)
+            init();
+        auto table = table_.get();
+        const sys_seconds window_begin = sys_days(transition_first_year / min_day);
+        const sys_seconds window_end = sys_days((transition_last_year + years {1}) / min_day);
+        auto interval = [&](std::size_t i) {
+            return offset_interval {table->transitions[i].begin,
+                i + 1 < table->transitions.size() ? table->transitions[i + 1].begin : table->end,
+                seconds {table->transitions[i].offset}};
+        };
+        auto emit = [&](std::size_t j, to_sys_status r, const offset_interval& first,
+            const offset_interval& second) {
+            out[j] = resolve_local(tp[j], r, first, second, policy);
+            if (status != nullptr)
+                status[j] = r;
+        };
+        // k is the entry found for the previous element, prev, if have_k
+        std::size_t k = 0;
+        bool have_k = false;
+        auto prev = local_seconds::min();
+        for (std::size_t j = 0; j < n; ++j) {
+            auto t = tp[j];
+            auto tpl = sys_seconds {t.time_since_epoch()};
+            // As in get_info_impl(local_seconds), but sorted input resumes the
+            // walk from the entry found for the element before.
+            if (table &&
+                tpl - days {1} >= window_begin && tpl + days {1} < window_end) {
+                if (!have_k || t < prev ||
+                    (k + 16 < table->transitions.size() &&
+                     table->transitions[k + 16].begin <= tpl - days {1}))
+                    k = find_transition(tpl - days {1});
+                while (k + 1 < table->transitions.size() &&
+                       table->transitions[k + 1].begin + seconds {table->transitions[k].offset} <= tpl)
+                    ++k;
+                have_k = true;
+                prev = t;
+                if (k >= 1 && k + 1 < table->transitions.size()) {
+                    auto first = interval(k);
+                    auto tps = tpl - first.offset;
+                    if (tps < first.begin)
+                        emit(j, to_sys_status::nonexistent, interval(k - 1), first);
+                    else if (first.end - tps <= days {1} &&
+                             tpl - seconds {table->transitions[k + 1].offset} >=
+                                 table->transitions[k + 1].begin)
+                        emit(j, to_sys_status::ambiguous, first, interval(k + 1));
+                    else
+                        emit(j, to_sys_status::unique, first, {});
+                    continue;
+                }
+            }
+            auto li = get_info_impl(t);
+            emit(j, static_cast<to_sys_status>(li.result),
+                make_offset_interval(li.first), make_offset_interval(li.second));
+        }
+    }
+
+    sys_info
         time_zone::get_info_impl(sys_seconds tp) const {
-        return get_info_impl(tp, static_cast<int>(tz::utc));
+        using namespace date;
+        if (is_fixed_at(tp))
+            return load_sys_info(0);
+        const bool in_table = prepare(tp);
+        const void* key = in_table ? static_cast<const void*>(table_.get()) : this;
+        // A cached interval may reach past max_year, where the rules throw
+        if (in_table || in_year_range(tp))
+            if (auto c = find_cached_info(key, tp))
+                return *c;
+        auto r = in_table ? load_sys_info(find_transition(tp))
+                          : get_info_impl(tp, static_cast<int>(tz::utc));
+        cache_info(key, r);
+        return r;
+    }
+
+    std::chrono::seconds
+        time_zone::get_offset_impl(sys_seconds tp) const {
+        using namespace date;
+        if (is_fixed_at(tp))
+            return std::chrono::seconds {table_->transitions.front().offset};
+        if (prepare(tp))
+            return std::chrono::seconds {table_->transitions[find_transition(tp)].offset};
+        return get_info_impl(tp).offset;
+    }
+
+    static const std::size_t no_transition = static_cast<std::size_t>(-1);
+
+    // Returns the entry of the table in effect at tp: the last one whose
+    // local start, measured with the offset before it, is not after tp.  Gives
+    // no_transition unless that entry and both of its neighbours are in the
+    // table.
+    std::size_t
+        time_zone::find_local_transition(local_seconds tp) const {
+        using namespace std::chrono;
+        using namespace date;
+        // Stay a day away from the window edges so that both neighbours of the
+        // entry found are in the table too.
+        auto tpl = sys_seconds {tp.time_since_epoch()};
+        if (table_ == nullptr ||
+            tpl - days {1} < sys_days(transition_first_year / min_day) ||
+            tpl + days {1} >= sys_days((transition_last_year + years {1}) / min_day))
+            return no_transition;
+        auto const& transitions = table_->transitions;
+        auto k = find_transition(tpl - days {1});
+        while (k + 1 < transitions.size() &&
+               transitions[k + 1].begin + seconds {transitions[k].offset} <= tpl)
+            ++k;
+        if (k >= 1 && k + 1 < transitions.size())
+            return k;
+        return no_transition;
+    }
+
+    std::chrono::seconds
+        time_zone::get_offset_impl(local_seconds tp) const {
+        using namespace std::chrono;
+        if (fixed_) {
+            seconds offset {table_->transitions.front().offset};
+            auto tpl = sys_seconds {tp.time_since_epoch()};
+            if (is_fixed_at(tpl) && is_fixed_at(tpl - offset))
+                return offset;
+        }
+        prepare(tp);
+        auto k = find_local_transition(tp);
+        if (k == no_transition)
+            return get_info_impl(tp).first.offset;
+        auto const& x = table_->transitions[k];
+        // Nonexistent times report the offset before the gap, as get_info_impl
+        // does
+        if (sys_seconds {(tp - seconds {x.offset}).time_since_epoch()} < x.begin)
+            return seconds {table_->transitions[k - 1].offset};
+        return seconds {x.offset};
+    }
+
+    std::string
+        time_zone::get_abbrev_impl(sys_seconds tp) const {
+        using namespace date;
+        if (is_fixed_at(tp))
+            return abbrevs_[table_->transitions.front().abbrev];
+        if (prepare(tp))
+            return abbrevs_[table_->transitions[find_transition(tp)].abbrev];
+        return get_info_impl(tp, static_cast<int>(tz::utc)).abbrev;
     }
 
     local_info
         time_zone::get_info_impl(local_seconds tp) const {
         using namespace std::chrono;
+        using namespace date;
         local_info i {};
+        auto tpl = sys_seconds {tp.time_since_epoch()};
+        if (is_fixed_at(tpl) && is_fixed_at(tpl - seconds {table_->transitions.front().offset})) {
+            i.first = load_sys_info(0);
+            return i;
+        }
+        // Answers found in the table are cached under it, the rest under this
+        const bool in_table = prepare(tp);
+        // As for sys_seconds, the rules reject what is out of range
+        if (in_table || in_year_range(tpl)) {
+            if (auto c = find_cached_info(in_table ? static_cast<const void*>(table_.get()) : this, tp)) {
+                i.first = *c;
+                return i;
+            }
+        }
+        auto k = find_local_transition(tp);
+        if (k != no_transition) {
+            i.first = load_sys_info(k);
+            auto tps = sys_seconds {(tp - i.first.offset).time_since_epoch()};
+            if (tps < i.first.begin) {
+                i.second = std::move(i.first);
+                i.first = load_sys_info(k - 1);
+                i.result = local_info::nonexistent;
+            } else if (i.first.end - tps <= days {1}) {
+                auto const& n = table_->transitions[k + 1];
+                if (sys_seconds {(tp - seconds {n.offset}).time_since_epoch()} >= n.begin) {
+                    i.second = load_sys_info(k + 1);
+                    i.result = local_info::ambiguous;
+                }
+            }
+            cache_info(table_.get(), i);
+            return i;
+        }
+        // Next to the ends of the table the rules answer, also for a mapped
+        // zone that prepare left uninitialized
+        init();
         i.first = get_info_impl(sys_seconds {tp.time_since_epoch()}, static_cast<int>(tz::local));
         auto tps = sys_seconds {(tp - i.first.offset).time_since_epoch()};
         if (tps < i.first.begin) {
@@ -2041,17 +3582,18 @@ namespace date {
             else
                 i.second = {};
         }
+        cache_info(this, i);
         return i;
     }
 
     void
-        time_zone::add(const std::string& s) {
+        time_zone::add(const std::string& s, detail::string_interner& strings) {
         try {
             std::istringstream in(s);
             in.exceptions(std::ios::failbit | std::ios::badbit);
             ws(in);
             if (!in.eof() && in.peek() != '#')
-                parse_info(in);
+                parse_info(in, strings);
         } catch (...) {
             std::cerr << s << '\n';
             std::cerr << *this << '\n';
@@ -2061,16 +3603,19 @@ namespace date {
     }
 
     void
-        time_zone::parse_info(std::istream& in) {
+        time_zone::parse_info(std::istream& in, detail::string_interner& strings) {
         using namespace date;
         using namespace std::chrono;
         zonelets_.emplace_back();
         auto& zonelet = zonelets_.back();
         zonelet.gmtoff_ = parse_signed_time(in);
-        in >> zonelet.u.rule_;
-        if (zonelet.u.rule_ == "-")
-            zonelet.u.rule_.clear();
-        in >> zonelet.format_;
+        std::string word;
+        in >> word;
+        if (word == "-")
+            word.clear();
+        zonelet.u.rule_ = strings.intern(word);
+        in >> word;
+        zonelet.format_ = strings.intern(word);
         if (!in.eof())
             ws(in);
         if (in.eof() || in.peek() == '#') {
@@ -2088,8 +3633,27 @@ namespace date {
             zonelets_.pop_back();
     }
 
+    // The place of r among the rules of the run that starts at first
+    static
+        std::pair<std::uint16_t, date::year>
+        rule_place(const Rule* first, const std::pair<const Rule*, date::year>& r) {
+        if (r.first == nullptr)
+            return {detail::no_rule, r.second};
+        return {static_cast<std::uint16_t>(r.first - first), r.second};
+    }
+
+    // The rule at place r in the run that starts at first
+    static
+        std::pair<const Rule*, date::year>
+        rule_at(const Rule* first, const std::pair<std::uint16_t, date::year>& r) {
+        if (r.first == detail::no_rule)
+            return {nullptr, r.second};
+        return {first + r.first, r.second};
+    }
+
     void
-        time_zone::adjust_infos(const std::vector<Rule>& rules) {
+        time_zone::adjust_infos(const std::vector<Rule>& rules,
+            const std::vector<std::string>& strings) {
         using namespace std::chrono;
         using namespace date;
         const zonelet* prev_zonelet = nullptr;
@@ -2098,27 +3662,20 @@ namespace date {
             std::istringstream in;
             in.exceptions(std::ios::failbit | std::ios::badbit);
             // Classify info as rule-based, has save, or neither
-            if (!z.u.rule_.empty()) {
+            if (z.u.rule_ != 0) {
                 // Find out if this zonelet has a rule or a save
-                eqr = std::equal_range(rules.data(), rules.data() + rules.size(), z.u.rule_);
+                eqr = find_rules(rules, z.u.rule_);
                 if (eqr.first == eqr.second) {
                     // The rule doesn't exist.  Assume this is a save
+                    auto const& rule = strings[z.u.rule_];
                     try {
                         using namespace std::chrono;
-                        using string = std::string;
-                        in.str(z.u.rule_);
+                        in.str(rule);
                         auto tmp = duration_cast<minutes>(parse_signed_time(in));
-#if !defined(_MSC_VER) || (_MSC_VER >= 1900)
-                        z.u.rule_.~string();
-                        z.tag_ = zonelet::has_save;
-                        ::new(&z.u.save_) minutes(tmp);
-#else
-                        z.u.rule_.clear();
                         z.tag_ = zonelet::has_save;
                         z.u.save_ = tmp;
-#endif
                     } catch (...) {
-                        std::cerr << name_ << " : " << z.u.rule_ << '\n';
+                        std::cerr << name_ << " : " << rule << '\n';
                         throw;
                     }
                 }
@@ -2127,14 +3684,16 @@ namespace date {
                 z.tag_ = zonelet::is_empty;
             }
 
+            std::pair<const Rule*, date::year> first_rule {nullptr, year::min()};
+            std::pair<const Rule*, date::year> last_rule {nullptr, year::max()};
             minutes final_save {0};
             if (z.tag_ == zonelet::has_save) {
                 final_save = z.u.save_;
             } else if (z.tag_ == zonelet::has_rule) {
-                z.last_rule_ = find_rule_for_zone(eqr, z.until_year_, z.gmtoff_,
+                last_rule = find_rule_for_zone(eqr, z.until_year_, z.gmtoff_,
                     z.until_date_);
-                if (z.last_rule_.first != nullptr)
-                    final_save = z.last_rule_.first->save();
+                if (last_rule.first != nullptr)
+                    final_save = last_rule.first->save();
             }
             z.until_utc_ = z.until_date_.to_sys(z.until_year_, z.gmtoff_, final_save);
             z.until_std_ = local_seconds {z.until_utc_.time_since_epoch()} +z.gmtoff_;
@@ -2142,37 +3701,39 @@ namespace date {
 
             if (z.tag_ == zonelet::has_rule) {
                 if (prev_zonelet != nullptr) {
-                    z.first_rule_ = find_rule_for_zone(eqr, prev_zonelet->until_utc_,
+                    first_rule = find_rule_for_zone(eqr, prev_zonelet->until_utc_,
                         prev_zonelet->until_std_,
                         prev_zonelet->until_loc_);
-                    if (z.first_rule_.first != nullptr) {
-                        z.initial_save_ = z.first_rule_.first->save();
-                        z.initial_abbrev_ = z.first_rule_.first->abbrev();
-                        if (z.first_rule_ != z.last_rule_) {
-                            z.first_rule_ = find_next_rule(eqr.first, eqr.second,
-                                z.first_rule_.first,
-                                z.first_rule_.second);
+                    if (first_rule.first != nullptr) {
+                        z.initial_save_ = first_rule.first->save();
+                        z.initial_abbrev_ = first_rule.first->abbrev_id();
+                        if (first_rule != last_rule) {
+                            first_rule = find_next_rule(eqr.first, eqr.second,
+                                first_rule.first,
+                                first_rule.second);
                         } else {
-                            z.first_rule_ = std::make_pair(nullptr, year::min());
-                            z.last_rule_ = std::make_pair(nullptr, year::max());
+                            first_rule = std::make_pair(nullptr, year::min());
+                            last_rule = std::make_pair(nullptr, year::max());
                         }
                     }
                 }
-                if (z.first_rule_.first == nullptr && z.last_rule_.first != nullptr) {
-                    z.first_rule_ = std::make_pair(eqr.first, eqr.first->starting_year());
-                    z.initial_abbrev_ = find_first_std_rule(eqr)->abbrev();
+                if (first_rule.first == nullptr && last_rule.first != nullptr) {
+                    first_rule = std::make_pair(eqr.first, eqr.first->starting_year());
+                    z.initial_abbrev_ = find_first_std_rule(eqr, strings)->abbrev_id();
                 }
             }
 
 #ifndef NDEBUG
-            if (z.first_rule_.first == nullptr) {
-                assert(z.first_rule_.second == year::min());
-                assert(z.last_rule_.first == nullptr);
-                assert(z.last_rule_.second == year::max());
+            if (first_rule.first == nullptr) {
+                assert(first_rule.second == year::min());
+                assert(last_rule.first == nullptr);
+                assert(last_rule.second == year::max());
             } else {
-                assert(z.last_rule_.first != nullptr);
+                assert(last_rule.first != nullptr);
             }
 #endif
+            z.first_rule_ = rule_place(eqr.first, first_rule);
+            z.last_rule_ = rule_place(eqr.first, last_rule);
             prev_zonelet = &z;
         }
     }
@@ -2225,8 +3786,135 @@ namespace date {
         return format;
     }
 
+    // Records every abbreviation the zonelets of this zone can produce in
+    // interner, so that lookups can refer to them by index.  The list of each
+    // zonelet is a range of zonelet_abbrevs_.
+    void
+        time_zone::intern_abbrevs(const std::vector<Rule>& rules,
+            const std::vector<std::string>& strings,
+            detail::abbrev_interner& interner, detail::undocumented) {
+        using namespace std::chrono;
+        zonelet_abbrevs_.clear();
+        for (auto& z : zonelets_) {
+            auto first = zonelet_abbrevs_.size();
+            auto add = [&](std::uint16_t letters, minutes save) {
+                for (auto i = first; i < zonelet_abbrevs_.size(); ++i)
+                    if (zonelet_abbrevs_[i].save == save && zonelet_abbrevs_[i].letters == letters)
+                        return;
+                auto s = format_abbrev(strings[z.format_], strings[letters],
+                    z.gmtoff_ + save, save);
+                zonelet_abbrevs_.push_back({save, letters, interner.intern(s)});
+            };
+            add(0, minutes {0});
+            if (z.tag_ == zonelet::has_save) {
+                add(0, z.u.save_);
+            } else if (z.tag_ == zonelet::has_rule && z.u.rule_ != 0) {
+                auto eqr = find_rules(rules, z.u.rule_);
+                if (eqr.first == eqr.second) {
+                    // Not a rule, so it will be classified as a save
+                    try {
+                        std::istringstream in(strings[z.u.rule_]);
+                        in.exceptions(std::ios::failbit | std::ios::badbit);
+                        add(0, duration_cast<minutes>(parse_signed_time(in)));
+                    } catch (...) {
+                    }
+                }
+                for (auto r = eqr.first; r != eqr.second; ++r)
+                    add(r->abbrev_id(), r->save());
+            }
+            z.abbrevs_offset_ = static_cast<std::uint16_t>(first);
+            z.abbrevs_count_ = static_cast<std::uint16_t>(zonelet_abbrevs_.size() - first);
+        }
+        zonelet_abbrevs_.shrink_to_fit();
+    }
+
+    // Ties this zone to the tables of the tzdb that owns it, so that it keeps
+    // using them after a newer tzdb is pushed to the front of the list.
+    void
+        time_zone::attach(const tzdb& db, detail::undocumented) {
+        abbrevs_ = db.abbrevs.data();
+        rules_ = &db.rules;
+        strings_ = &db.strings;
+        // One zonelet that names no rules means one offset for all time.  Build
+        // its table now so that lookups can answer from it directly.
+        if (zonelets_.size() == 1) {
+            auto const& z = zonelets_.front();
+            if (z.tag_ != zonelet::has_rule || z.u.rule_ == 0 ||
+                !std::binary_search(db.rules.begin(), db.rules.end(), z.u.rule_,
+                    find_rule_by_name {})) {
+                init();
+                fixed_ = table_ != nullptr && table_->transitions.size() == 1;
+            }
+        }
+    }
+
+    // Appends the names in the rule column of this zone's zonelets, rules or not
+    void
+        time_zone::used_rules(const std::vector<std::string>& strings,
+            std::vector<std::string>& names, detail::undocumented) const {
+        for (auto const& z : zonelets_) {
+            if (z.tag_ == zonelet::has_rule && z.u.rule_ != 0)
+                names.push_back(strings[z.u.rule_]);
+        }
+    }
+
+    void
+        time_zone::share_table(detail::transition_registry& tables, detail::undocumented) {
+        init();
+        if (table_ == nullptr)
+            return;
+        auto i = tables.tables.find(table_.get());
+        if (i != tables.tables.end())
+            table_ = i->second;
+        else
+            tables.tables.emplace(table_.get(), table_);
+    }
+
+    // Serves lookups inside of the window from table, a table of this zone
+    // mapped from a tzdb image, without initializing the zone first
+    void
+        time_zone::map_table(std::shared_ptr<const detail::transition_table> table,
+            detail::undocumented) {
+        table_ = std::move(table);
+        mapped_ = true;
+    }
+
+    const detail::transition_table*
+        time_zone::get_table(detail::undocumented) const {
+        init();
+        return table_.get();
+    }
+
+    const std::vector<Rule>&
+        time_zone::get_rules() const {
+        return rules_ != nullptr ? *rules_ : get_tzdb().rules;
+    }
+
+    const std::vector<std::string>&
+        time_zone::get_strings() const {
+        return strings_ != nullptr ? *strings_ : get_tzdb().strings;
+    }
+
+    static
+        std::uint16_t
+        find_abbrev(const detail::zonelet& z, const std::vector<detail::zonelet_abbrev>& abbrevs,
+            const std::vector<std::string>& strings, const std::string& letters,
+            std::chrono::minutes save) {
+        auto first = abbrevs.data() + z.abbrevs_offset_;
+        for (auto a = first; a != first + z.abbrevs_count_; ++a)
+            if (a->save == save && strings[a->letters] == letters)
+                return a->id;
+        return detail::no_abbrev;
+    }
+
     sys_info
         time_zone::get_info_impl(sys_seconds tp, int tz_int) const {
+        std::uint16_t abbrev;
+        return get_info_impl(tp, tz_int, abbrev);
+    }
+
+    sys_info
+        time_zone::get_info_impl(sys_seconds tp, int tz_int, std::uint16_t& abbrev) const {
         using namespace std::chrono;
         using namespace date;
         tz timezone = static_cast<tz>(tz_int);
@@ -2236,10 +3924,6 @@ namespace date {
             throw std::runtime_error("The year " + std::to_string(static_cast<int>(y)) +
                 " is out of range:[" + std::to_string(static_cast<int>(min_year)) + ", "
                 + std::to_string(static_cast<int>(max_year)) + "]");
-        std::call_once(*adjusted_,
-            [this]() {
-                const_cast<time_zone*>(this)->adjust_infos(get_tzdb().rules);
-            });
         auto i = std::upper_bound(zonelets_.begin(), zonelets_.end(), tp,
             [timezone](sys_seconds t, const zonelet& zl) {
                 return timezone == tz::utc ? t < zl.until_utc_ :
@@ -2247,7 +3931,9 @@ namespace date {
             });
 
         sys_info r {};
+        abbrev = detail::no_abbrev;
         if (i != zonelets_.end()) {
+            auto const& strings = get_strings();
             if (i->tag_ == zonelet::has_save) {
                 if (i != zonelets_.begin())
                     r.begin = i[-1].until_utc_;
@@ -2256,7 +3942,7 @@ namespace date {
                 r.end = i->until_utc_;
                 r.offset = i->gmtoff_ + i->u.save_;
                 r.save = i->u.save_;
-            } else if (i->u.rule_.empty()) {
+            } else if (i->u.rule_ == 0) {
                 if (i != zonelets_.begin())
                     r.begin = i[-1].until_utc_;
                 else
@@ -2264,16 +3950,27 @@ namespace date {
                 r.end = i->until_utc_;
                 r.offset = i->gmtoff_;
             } else {
-                r = find_rule(i->first_rule_, i->last_rule_, y, i->gmtoff_,
-                    MonthDayTime(local_seconds {tp.time_since_epoch()}, timezone),
-                    i->initial_save_, i->initial_abbrev_);
+                if (i + 1 != zonelets_.end() || recurring_ == nullptr ||
+                    !find_recurring(*recurring_, y, tp, timezone, strings, r)) {
+                    auto const& rules = get_rules();
+                    auto first = find_rules(rules, i->u.rule_).first;
+                    r = find_rule(rule_at(first, i->first_rule_), rule_at(first, i->last_rule_),
+                        y, i->gmtoff_,
+                        MonthDayTime(local_seconds {tp.time_since_epoch()}, timezone),
+                        i->initial_save_, i->initial_abbrev_, rules, strings);
+                }
                 r.offset = i->gmtoff_ + r.save;
                 if (i != zonelets_.begin() && r.begin < i[-1].until_utc_)
                     r.begin = i[-1].until_utc_;
                 if (r.end > i->until_utc_)
                     r.end = i->until_utc_;
             }
-            r.abbrev = format_abbrev(i->format_, r.abbrev, r.offset, r.save);
+            if (abbrevs_ != nullptr)
+                abbrev = find_abbrev(*i, zonelet_abbrevs_, strings, r.abbrev, r.save);
+            if (abbrev != detail::no_abbrev)
+                r.abbrev = abbrevs_[abbrev];
+            else
+                r.abbrev = format_abbrev(strings[i->format_], r.abbrev, r.offset, r.save);
             assert(r.begin < r.end);
         }
         return r;
@@ -2286,10 +3983,9 @@ namespace date {
         detail::save_ostream<char> _(os);
         os.fill(' ');
         os.flags(std::ios::dec | std::ios::left);
-        std::call_once(*z.adjusted_,
-            [&z]() {
-                const_cast<time_zone&>(z).adjust_infos(get_tzdb().rules);
-            });
+        z.init();
+        auto const& rules = z.get_rules();
+        auto const& strings = z.get_strings();
         os.width(35);
         os << z.name_;
         std::string indent;
@@ -2300,28 +3996,35 @@ namespace date {
             os << make_time(s.gmtoff_) << "   ";
             os.width(15);
             if (s.tag_ != zonelet::has_save)
-                os << s.u.rule_;
+                os << strings[s.u.rule_];
             else {
                 std::ostringstream tmp;
                 tmp << make_time(s.u.save_);
                 os << tmp.str();
             }
             os.width(8);
-            os << s.format_ << "   ";
+            os << strings[s.format_] << "   ";
             os << s.until_year_ << ' ' << s.until_date_;
             os << "   " << s.until_utc_ << " UTC";
             os << "   " << s.until_std_ << " STD";
             os << "   " << s.until_loc_;
             os << "   " << make_time(s.initial_save_);
-            os << "   " << s.initial_abbrev_;
-            if (s.first_rule_.first != nullptr)
-                os << "   {" << *s.first_rule_.first << ", " << s.first_rule_.second << '}';
+            os << "   " << strings[s.initial_abbrev_];
+            const Rule* first = nullptr;
+            if (s.tag_ == zonelet::has_rule)
+                first = find_rules(rules, s.u.rule_).first;
+            auto first_rule = rule_at(first, s.first_rule_);
+            auto last_rule = rule_at(first, s.last_rule_);
+            if (first_rule.first != nullptr)
+                os << "   {" << named_rule {*first_rule.first, strings} << ", "
+                   << first_rule.second << '}';
             else
-                os << "   {" << "nullptr" << ", " << s.first_rule_.second << '}';
-            if (s.last_rule_.first != nullptr)
-                os << "   {" << *s.last_rule_.first << ", " << s.last_rule_.second << '}';
+                os << "   {" << "nullptr" << ", " << first_rule.second << '}';
+            if (last_rule.first != nullptr)
+                os << "   {" << named_rule {*last_rule.first, strings} << ", "
+                   << last_rule.second << '}';
             else
-                os << "   {" << "nullptr" << ", " << s.last_rule_.second << '}';
+                os << "   {" << "nullptr" << ", " << last_rule.second << '}';
             os << '\n';
             if (indent.empty())
                 indent = std::string(35, ' ');
@@ -2343,7 +4046,6 @@ namespace date {
 
 #if USE_OS_TZDB
 
-# ifdef __APPLE__
     static
         std::string
         get_version() {
@@ -2356,11 +4058,10 @@ namespace date {
             throw std::runtime_error("Unable to get Timezone database version from " + path);
         return version;
     }
-# endif
 
     static
         std::unique_ptr<tzdb>
-        init_tzdb() {
+        init_tzdb(const tzdb*) {
         std::unique_ptr<tzdb> db(new tzdb);
 
         //Iterate through folders
@@ -2404,24 +4105,25 @@ namespace date {
         }
         db->zones.shrink_to_fit();
         std::sort(db->zones.begin(), db->zones.end());
+        build_zone_index(*db);
 #  if !MISSING_LEAP_SECONDS
-        std::ifstream in(get_tz_dir() + std::string(1, folder_delimiter) + "right/UTC",
-            std::ios_base::binary);
-        if (in) {
-            in.exceptions(std::ios::failbit | std::ios::badbit);
-            db->leap_seconds = load_just_leaps(in);
+        mapped_file right(get_tz_dir() + std::string(1, folder_delimiter) + "right/UTC");
+        if (right.is_open()) {
+            db->leap_seconds = load_just_leaps(right);
         } else {
-            in.clear();
-            in.open(get_tz_dir() + std::string(1, folder_delimiter) +
-                "UTC", std::ios_base::binary);
-            if (!in)
+            mapped_file utc(get_tz_dir() + std::string(1, folder_delimiter) + "UTC");
+            if (!utc.is_open())
                 throw std::runtime_error("Unable to extract leap second information");
-            in.exceptions(std::ios::failbit | std::ios::badbit);
-            db->leap_seconds = load_just_leaps(in);
+            db->leap_seconds = load_just_leaps(utc);
         }
 #  endif  // !MISSING_LEAP_SECONDS
 #  ifdef __APPLE__
         db->version = get_version();
+#  else
+        // Only some trees have one, such as those written by tools/export_tzif
+        struct stat vs;
+        if (stat((get_tz_dir() + "/+VERSION").c_str(), &vs) == 0)
+            db->version = get_version();
 #  endif
         return db;
     }
@@ -2461,6 +4163,8 @@ namespace date {
         date_ = date.to_time_point(year(y));
     }
 
+#if !EMBEDDED_TZDB || HAS_REMOTE_API
+
     static
         bool
         file_exists(const std::string& filename) {
@@ -2471,6 +4175,157 @@ namespace date {
 #endif
     }
 
+    // Whether the install names a tzdata archive rather than a folder
+    static
+        bool
+        is_archive_install(const std::string& install) {
+#if HAS_ZLIB
+        auto ends_with = [&install](const char* s) {
+            auto n = std::strlen(s);
+            return install.size() > n && install.compare(install.size() - n, n, s) == 0;
+        };
+        return ends_with(".tar.gz") || ends_with(".tgz");
+#else  // !HAS_ZLIB
+        (void)install;
+        return false;
+#endif  // !HAS_ZLIB
+    }
+
+#endif  // !EMBEDDED_TZDB || HAS_REMOTE_API
+
+#if HAS_ZLIB
+
+    // tar.gz reading
+
+    namespace {
+
+        struct gz_closer {
+            void operator()(gzFile f) const {
+                ::gzclose(f);
+            }
+        };
+
+    }  // unnamed namespace
+
+    // Reads exactly n bytes, or returns false
+    static
+        bool
+        read_gz(gzFile f, char* p, std::size_t n) {
+        while (n > 0) {
+            auto k = ::gzread(f, p, static_cast<unsigned>(std::min<std::size_t>(n, 1u << 20)));
+            if (k <= 0)
+                return false;
+            p += k;
+            n -= static_cast<std::size_t>(k);
+        }
+        return true;
+    }
+
+    static
+        std::size_t
+        tar_number(const char* p, std::size_t n) {
+        std::size_t r = 0;
+        for (; n > 0 && *p == ' '; ++p, --n)
+            ;
+        for (; n > 0 && '0' <= *p && *p <= '7'; ++p, --n)
+            r = r * 8 + static_cast<std::size_t>(*p - '0');
+        return r;
+    }
+
+    static
+        std::string
+        tar_string(const char* p, std::size_t n) {
+        return std::string(p, std::find(p, p + n, '\0'));
+    }
+
+    // The largest archive member read or skipped.  tzdata files are a few
+    // hundred kilobytes at most.
+    CONSTDATA std::size_t tar_member_limit = 16 * 1024 * 1024;
+
+    // Calls f(name, contents) for each regular file in the gzipped tar archive
+    // at path that want(name) accepts, in archive order, with any leading "./"
+    // taken off the name.  Other members are decompressed past without being
+    // held.  Long names in GNU and pax headers are followed.  Throws if the
+    // archive can not be read or has a member over tar_member_limit.
+    template <class W, class F>
+    static
+        void
+        for_each_tar_gz_file(const std::string& path, W want, F f) {
+        std::unique_ptr<gzFile_s, gz_closer> gz{::gzopen(path.c_str(), "rb")};
+        if (!gz)
+            throw std::runtime_error("Unable to open " + path);
+        ::gzbuffer(gz.get(), 1u << 16);
+        auto bad = [&path]() {
+            return std::runtime_error(path + " is not a readable tar.gz archive");
+        };
+        char h[512];
+        std::string data;
+        std::string next_name;
+        // Two zero blocks end the archive, though running out at a header is
+        // accepted too
+        while (read_gz(gz.get(), h, sizeof(h))) {
+            if (std::all_of(h, h + sizeof(h), [](char c) {return c == '\0';}))
+                return;
+            unsigned sum = 0;
+            for (std::size_t i = 0; i < sizeof(h); ++i)
+                sum += 148 <= i && i < 156 ? ' ' : static_cast<unsigned char>(h[i]);
+            if (sum != tar_number(h + 148, 8))
+                throw bad();
+            auto size = tar_number(h + 124, 12);
+            if (size > tar_member_limit)
+                throw bad();
+            auto padded = (size + 511) / 512 * 512;
+            auto read_data = [&]() {
+                data.resize(size);
+                char pad[512];
+                if ((size > 0 && !read_gz(gz.get(), &data[0], size)) ||
+                    (padded != size && !read_gz(gz.get(), pad, padded - size)))
+                    throw bad();
+            };
+            auto type = h[156];
+            if (type == 'L') {
+                read_data();
+                next_name = tar_string(data.data(), data.size());
+                continue;
+            }
+            if (type == 'x') {
+                read_data();
+                // Records of the form "<length> <key>=<value>\n"
+                for (std::size_t i = 0; i < data.size();) {
+                    auto len = static_cast<std::size_t>(std::strtoul(data.c_str() + i, nullptr, 10));
+                    auto sp = data.find(' ', i);
+                    if (len == 0 || sp == std::string::npos || i + len > data.size())
+                        throw bad();
+                    if (data.compare(sp + 1, 5, "path=") == 0)
+                        next_name = data.substr(sp + 6, i + len - 1 - (sp + 6));
+                    i += len;
+                }
+                continue;
+            }
+            std::string name;
+            if (!next_name.empty())
+                name.swap(next_name);
+            else {
+                name = tar_string(h, 100);
+                if (std::memcmp(h + 257, "ustar", 5) == 0 && h[345] != '\0')
+                    name = tar_string(h + 345, 155) + '/' + name;
+            }
+            if (name.compare(0, 2, "./") == 0)
+                name.erase(0, 2);
+            if ((type != '0' && type != '\0') || !want(name)) {
+                if (padded > 0 && ::gzseek(gz.get(), static_cast<z_off_t>(padded), SEEK_CUR) < 0)
+                    throw bad();
+                continue;
+            }
+            read_data();
+            f(name, data);
+        }
+        if (::gzeof(gz.get()) == 0)
+            throw bad();
+    }
+
+#endif  // HAS_ZLIB
+
 #if HAS_REMOTE_API
 
     // CURL tools
@@ -2493,25 +4348,222 @@ namespace date {
 
     }  // unnamed namespace
 
+    namespace {
+
+        struct remote_settings {
+            std::mutex        mutex;
+            remote_options    options;
+            // Set at exit, see stop_remote
+            std::atomic<bool> stop {false};
+        };
+
+    }  // unnamed namespace
+
+    static
+        remote_settings&
+        get_remote_settings() {
+        static remote_settings settings;
+        return settings;
+    }
+
+    void
+        set_remote_options(const remote_options& options) {
+        auto& rs = get_remote_settings();
+        std::lock_guard<std::mutex> lock(rs.mutex);
+        rs.options = options;
+    }
+
+    remote_options
+        get_remote_options() {
+        auto& rs = get_remote_settings();
+        std::lock_guard<std::mutex> lock(rs.mutex);
+        return rs.options;
+    }
+
     static
         std::unique_ptr<CURL, curl_deleter>
         curl_init() {
         static const auto curl_is_now_initiailized = curl_global();
         (void)curl_is_now_initiailized;
-        return std::unique_ptr<CURL, curl_deleter>{::curl_easy_init()};
+        std::unique_ptr<CURL, curl_deleter> curl{::curl_easy_init()};
+        if (curl) {
+            // Bound every request so a dead server can not hold up an update
+            // indefinitely
+            auto options = get_remote_options();
+            curl_easy_setopt(curl.get(), CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT_MS,
+                static_cast<long>(options.connect_timeout.count()));
+            curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT_MS,
+                static_cast<long>(options.timeout.count()));
+            // Called about once a second even while nothing arrives, so
+            // stop_remote cuts a request short within a second or so
+            curl_xferinfo_callback progress_cb = [](void* userp, curl_off_t, curl_off_t,
+                curl_off_t, curl_off_t) -> int {
+                    return static_cast<remote_settings*>(userp)->stop.load() ? 1 : 0;
+            };
+            curl_easy_setopt(curl.get(), CURLOPT_XFERINFOFUNCTION, progress_cb);
+            curl_easy_setopt(curl.get(), CURLOPT_XFERINFODATA, &get_remote_settings());
+            curl_easy_setopt(curl.get(), CURLOPT_NOPROGRESS, 0L);
+        }
+        return curl;
+    }
+
+#if AUTO_DOWNLOAD
+
+    // Aborts the request in progress and fails every later one, so that the
+    // threads exit waits for finish promptly
+    static
+        void
+        stop_remote() {
+        get_remote_settings().stop.store(true);
     }
 
     static
         bool
-        download_to_string(const std::string& url, std::string& str) {
-        str.clear();
-        auto curl = curl_init();
-        if (!curl)
-            return false;
-        std::string version;
-        curl_easy_setopt(curl.get(), CURLOPT_USERAGENT, "curl");
-        curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
-        curl_write_callback write_cb = [](char* contents, std::size_t size, std::size_t nmemb,
+        remote_stopped() {
+        return get_remote_settings().stop.load();
+    }
+
+#endif  // AUTO_DOWNLOAD
+
+    // HTTP revalidation
+    //
+    // The ETag and Last-Modified of the last 200 response for each URL are kept in
+    // <install>.http_cache, a line of "url\tetag\tlast-modified\tvalue" each, where
+    // value is what was taken from the body (the version, for the version page).
+    // The next request for the URL sends them back, so while nothing changes each
+    // check costs a 304 response.
+
+    namespace {
+
+        struct http_validators {
+            std::string etag;
+            std::string last_modified;
+            std::string value;
+        };
+
+        struct curl_slist_deleter {
+            void operator()(curl_slist* p) const {
+                ::curl_slist_free_all(p);
+            }
+        };
+
+    }  // unnamed namespace
+
+    static
+        std::mutex&
+        get_http_cache_mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    static
+        std::map<std::string, http_validators>
+        read_http_cache() {
+        std::map<std::string, http_validators> cache;
+        std::ifstream in(get_install() + ".http_cache");
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string url;
+            http_validators v;
+            if (std::getline(fields, url, '\t') && std::getline(fields, v.etag, '\t') &&
+                std::getline(fields, v.last_modified, '\t')) {
+                std::getline(fields, v.value);
+                cache[url] = v;
+            }
+        }
+        return cache;
+    }
+
+    static
+        bool
+        find_http_validators(const std::string& url, http_validators& v) {
+        if (!get_remote_options().revalidate)
+            return false;
+        std::lock_guard<std::mutex> lock(get_http_cache_mutex());
+        auto cache = read_http_cache();
+        auto i = cache.find(url);
+        if (i == cache.end())
+            return false;
+        v = i->second;
+        return true;
+    }
+
+    static
+        void
+        store_http_validators(const std::string& url, const http_validators& v) {
+        if (!get_remote_options().revalidate || (v.etag.empty() && v.last_modified.empty()))
+            return;
+        std::lock_guard<std::mutex> lock(get_http_cache_mutex());
+        auto cache = read_http_cache();
+        cache[url] = v;
+        std::ofstream out(get_install() + ".http_cache");
+        for (auto const& c : cache) {
+            out << c.first << '\t' << c.second.etag << '\t' << c.second.last_modified << '\t'
+                << c.second.value << '\n';
+        }
+    }
+
+    // Performs the request set up on curl, sending If-None-Match and
+    // If-Modified-Since from cached if given and collecting the validators of the
+    // response in fresh.  status is the HTTP status, or 0 for other schemes.
+    static
+        bool
+        perform_conditional(CURL* curl, const http_validators* cached,
+            http_validators& fresh, long& status) {
+        std::unique_ptr<curl_slist, curl_slist_deleter> headers;
+        if (cached) {
+            curl_slist* list = nullptr;
+            if (!cached->etag.empty())
+                list = ::curl_slist_append(list, ("If-None-Match: " + cached->etag).c_str());
+            if (!cached->last_modified.empty())
+                list = ::curl_slist_append(list,
+                    ("If-Modified-Since: " + cached->last_modified).c_str());
+            headers.reset(list);
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers.get());
+        }
+        curl_write_callback header_cb = [](char* contents, std::size_t size, std::size_t nmemb,
+            void* userp) -> std::size_t {
+                auto& v = *static_cast<http_validators*>(userp);
+                auto realsize = size * nmemb;
+                std::string line(contents, realsize);
+                auto colon = line.find(':');
+                if (colon != std::string::npos) {
+                    std::string name = line.substr(0, colon);
+                    for (auto& c : name)
+                        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                    auto b = line.find_first_not_of(" \t", colon + 1);
+                    auto e = line.find_last_not_of(" \t\r\n");
+                    auto value = b == std::string::npos || e < b ? std::string() :
+                        line.substr(b, e + 1 - b);
+                    if (name == "etag")
+                        v.etag = value;
+                    else if (name == "last-modified")
+                        v.last_modified = value;
+                }
+                return realsize;
+        };
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_cb);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &fresh);
+        status = 0;
+        if (curl_easy_perform(curl) != CURLE_OK)
+            return false;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        return true;
+    }
+
+    static
+        bool
+        download_to_string(const std::string& url, std::string& str,
+            const http_validators* cached, http_validators& fresh, long& status) {
+        str.clear();
+        auto curl = curl_init();
+        if (!curl)
+            return false;
+        curl_easy_setopt(curl.get(), CURLOPT_USERAGENT, "curl");
+        curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+        curl_write_callback write_cb = [](char* contents, std::size_t size, std::size_t nmemb,
             void* userp) -> std::size_t {
                 auto& userstr = *static_cast<std::string*>(userp);
                 auto realsize = size * nmemb;
@@ -2521,12 +4573,24 @@ namespace date {
         curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, write_cb);
         curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &str);
         curl_easy_setopt(curl.get(), CURLOPT_SSL_VERIFYPEER, false);
-        auto res = curl_easy_perform(curl.get());
-        return (res == CURLE_OK);
+        return perform_conditional(curl.get(), cached, fresh, status);
     }
 
     namespace {
         enum class download_file_options { binary, text };
+
+        // Opened on the first byte of the body, so that a 304 leaves the
+        // existing file as it is
+        struct download_sink {
+            const std::string*      filename;
+            std::ios_base::openmode mode;
+            std::ofstream           of;
+
+            void open() {
+                of.open(*filename, mode);
+                of.exceptions(std::ios::badbit);
+            }
+        };
     }
 
     static
@@ -2542,36 +4606,57 @@ namespace date {
             curl_easy_setopt(curl.get(), CURLOPT_ERRORBUFFER, error_buffer);
         curl_write_callback write_cb = [](char* contents, std::size_t size, std::size_t nmemb,
             void* userp) -> std::size_t {
-                auto& of = *static_cast<std::ofstream*>(userp);
+                auto& sink = *static_cast<download_sink*>(userp);
+                if (!sink.of.is_open())
+                    sink.open();
                 auto realsize = size * nmemb;
-                of.write(contents, static_cast<std::streamsize>(realsize));
+                sink.of.write(contents, static_cast<std::streamsize>(realsize));
                 return realsize;
         };
         curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, write_cb);
-        decltype(curl_easy_perform(curl.get())) res;
-        {
-            std::ofstream of(local_filename,
-                opts == download_file_options::binary ?
-                std::ofstream::out | std::ofstream::binary :
-                std::ofstream::out);
-            of.exceptions(std::ios::badbit);
-            curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &of);
-            res = curl_easy_perform(curl.get());
-        }
-        return res == CURLE_OK;
+        // Only revalidate a file that is still there to fall back on
+        http_validators cached;
+        auto have = file_exists(local_filename) && find_http_validators(url, cached);
+        http_validators fresh;
+        long status;
+        download_sink sink{&local_filename,
+            opts == download_file_options::binary ?
+            std::ofstream::out | std::ofstream::binary :
+            std::ofstream::out, {}};
+        curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &sink);
+        if (!perform_conditional(curl.get(), have ? &cached : nullptr, fresh, status))
+            return false;
+        if (status == 304 && have)
+            return true;
+        if (!sink.of.is_open())
+            sink.open();
+        if (status == 200)
+            store_http_validators(url, fresh);
+        return true;
     }
 
     std::string
         remote_version() {
         std::string version;
         std::string str;
-        if (download_to_string("https://www.iana.org/time-zones", str)) {
+        auto url = get_remote_options().version_url;
+        http_validators cached;
+        auto have = find_http_validators(url, cached);
+        http_validators fresh;
+        long status;
+        if (download_to_string(url, str, have ? &cached : nullptr, fresh, status)) {
+            if (status == 304 && have)
+                return cached.value;
             CONSTDATA char db[] = "/time-zones/releases/tzdata";
             CONSTDATA auto db_size = sizeof(db) - 1;
             auto p = str.find(db, 0, db_size);
             const int ver_str_len = 5;
             if (p != std::string::npos && p + (db_size + ver_str_len) <= str.size())
                 version = str.substr(p + db_size, ver_str_len);
+            if (!version.empty() && status == 200) {
+                fresh.value = version;
+                store_http_validators(url, fresh);
+            }
         }
         return version;
     }
@@ -2681,26 +4766,28 @@ namespace date {
 #  endif  // !_WIN32
     }
 
+#  if !HAS_ZLIB
     static
         bool
         delete_file(const std::string& file) {
-#  ifdef _WIN32
-#    if USE_SHELL_API
+#    ifdef _WIN32
+#      if USE_SHELL_API
         std::string cmd = "del \"";
         cmd += file;
         cmd += '\"';
         return std::system(cmd.c_str()) == 0;
-#    else  // !USE_SHELL_API
+#      else  // !USE_SHELL_API
         return _unlink(file.c_str()) == 0;
-#    endif // !USE_SHELL_API
-#  else  // !_WIN32
-#    if USE_SHELL_API
+#      endif // !USE_SHELL_API
+#    else  // !_WIN32
+#      if USE_SHELL_API
         return std::system(("rm " + file).c_str()) == EXIT_SUCCESS;
-#    else // !USE_SHELL_API
+#      else // !USE_SHELL_API
         return unlink(file.c_str()) == 0;
-#    endif // !USE_SHELL_API
-#  endif  // !_WIN32
+#      endif // !USE_SHELL_API
+#    endif  // !_WIN32
     }
+#  endif  // !HAS_ZLIB
 
 #  ifdef _WIN32
 
@@ -2798,6 +4885,7 @@ namespace date {
         return file;
     }
 
+#    if !HAS_ZLIB
     static
         bool
         extract_gz_file(const std::string& version, const std::string& gz_file,
@@ -2857,6 +4945,7 @@ namespace date {
 
         return unzip_result;
     }
+#    endif  // !HAS_ZLIB
 
     static
         std::string
@@ -2867,7 +4956,7 @@ namespace date {
 
 #  else  // !_WIN32
 
-#    if !USE_SHELL_API
+#    if !USE_SHELL_API && !HAS_ZLIB
     static
         int
         run_program(const char* prog, const char* const args[]) {
@@ -2906,8 +4995,9 @@ namespace date {
         exit(EXIT_FAILURE);
         return EXIT_FAILURE;
     }
-#    endif // !USE_SHELL_API
+#    endif // !USE_SHELL_API && !HAS_ZLIB
 
+#    if !HAS_ZLIB
     static
         bool
         extract_gz_file(const std::string&, const std::string& gz_file, const std::string&) {
@@ -2927,9 +5017,35 @@ namespace date {
         }
         return false;
     }
+#    endif  // !HAS_ZLIB
 
 #  endif // !_WIN32
 
+#  if HAS_ZLIB
+    // Unpacks the archive without running tar or 7-Zip.  tzdata releases are
+    // flat, so anything in a subfolder is left out.
+    static
+        bool
+        extract_gz_file(const std::string&, const std::string& gz_file,
+            const std::string& dest_folder) {
+        try {
+            for_each_tar_gz_file(gz_file, [](const std::string& name) {
+                    return !name.empty() && name.find_first_of("/\\") == std::string::npos;
+                }, [&dest_folder](const std::string& name, const std::string& data) {
+                    std::ofstream out(dest_folder + folder_delimiter + name,
+                        std::ios::out | std::ios::binary);
+                    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+                    if (!out)
+                        throw std::runtime_error("Unable to write " + name);
+            });
+        } catch (const std::exception&) {
+            return false;
+        }
+        std::remove(gz_file.c_str());
+        return true;
+    }
+#  endif  // HAS_ZLIB
+
     bool
         remote_download(const std::string& version, char* error_buffer) {
         assert(!version.empty());
@@ -2939,22 +5055,20 @@ namespace date {
 #  else  // !_WIN32
         // Create download folder if it does not exist on UNIX system
         auto download_folder = get_install();
-        if (!file_exists(download_folder)) {
+        if (!is_archive_install(download_folder) && !file_exists(download_folder)) {
             if (!make_directory(download_folder))
                 return false;
         }
 #  endif  // _WIN32
 
-        auto url = "https://data.iana.org/time-zones/releases/tzdata" + version +
-            ".tar.gz";
+        auto options = get_remote_options();
+        auto url = options.release_url + "tzdata" + version + ".tar.gz";
         bool result = download_to_file(url, get_download_gz_file(version),
             download_file_options::binary, error_buffer);
 #  ifdef _WIN32
         if (result) {
             auto mapping_file = get_download_mapping_file(version);
-            result = download_to_file(
-                "https://raw.githubusercontent.com/unicode-org/cldr/master/"
-                "common/supplemental/windowsZones.xml",
+            result = download_to_file(options.mapping_url,
                 mapping_file, download_file_options::text, error_buffer);
         }
 #  endif  // _WIN32
@@ -2968,6 +5082,22 @@ namespace date {
 
         std::string install = get_install();
         auto gz_file = get_download_gz_file(version);
+        std::lock_guard<std::mutex> lock(get_install_mutex());
+        if (is_archive_install(install)) {
+            // The download takes the place of the archive as it is
+            if (!file_exists(gz_file))
+                return false;
+            std::remove(install.c_str());
+            success = std::rename(gz_file.c_str(), install.c_str()) == 0;
+#  ifdef _WIN32
+            auto mapping_file_dest = install.substr(0, install.find_last_of("\\/") + 1);
+            mapping_file_dest += "windowsZones.xml";
+            std::remove(mapping_file_dest.c_str());
+            if (!move_file(get_download_mapping_file(version), mapping_file_dest))
+                success = false;
+#  endif  // _WIN32
+            return success;
+        }
         if (file_exists(gz_file)) {
             if (file_exists(install))
                 remove_folder_and_subfolders(install);
@@ -3011,191 +5141,1382 @@ namespace date {
         throw std::runtime_error("Unable to get Timezone database version from " + path);
     }
 
+    // Reads the Rule, Link, Leap and Zone lines of one region file into db.
     static
-        std::unique_ptr<tzdb>
-        init_tzdb() {
-        using namespace date;
-        const std::string install = get_install();
-        const std::string path = install + folder_delimiter;
+        void
+        parse_tzdata(tzdb& db, detail::string_interner& strings, std::istream& infile) {
         std::string line;
         bool continue_zone = false;
-        std::unique_ptr<tzdb> db(new tzdb);
-
-#if AUTO_DOWNLOAD
-        if (!file_exists(install)) {
-            auto rv = remote_version();
-            if (!rv.empty() && remote_download(rv)) {
-                if (!remote_install(rv)) {
-                    std::string msg = "Timezone database version \"";
-                    msg += rv;
-                    msg += "\" did not install correctly to \"";
-                    msg += install;
-                    msg += "\"";
-                    throw std::runtime_error(msg);
+        while (infile) {
+            std::getline(infile, line);
+            if (!line.empty() && line[0] != '#') {
+                std::istringstream in(line);
+                std::string word;
+                in >> word;
+                if (word == "Rule") {
+                    db.rules.push_back(Rule(line, strings));
+                    continue_zone = false;
+                } else if (word == "Link") {
+                    db.links.push_back(time_zone_link(line));
+                    continue_zone = false;
+                } else if (word == "Leap") {
+                    db.leap_seconds.push_back(leap_second(line, detail::undocumented {}));
+                    continue_zone = false;
+                } else if (word == "Zone") {
+                    db.zones.push_back(time_zone(line, strings, detail::undocumented {}));
+                    continue_zone = true;
+                } else if (line[0] == '\t' && continue_zone) {
+                    db.zones.back().add(line, strings);
+                } else {
+                    std::cerr << line << '\n';
                 }
             }
-            if (!file_exists(install)) {
-                std::string msg = "Timezone database not found at \"";
-                msg += install;
-                msg += "\"";
-                throw std::runtime_error(msg);
-            }
-            db->version = get_version(path);
-        } else {
-            db->version = get_version(path);
-            auto rv = remote_version();
-            if (!rv.empty() && db->version != rv) {
-                if (remote_download(rv)) {
-                    remote_install(rv);
-                    db->version = get_version(path);
+        }
+    }
+
+    namespace {
+
+        // A mapped tzdb image, or one compiled into the program, once checked,
+        // and the tables of its zones, which point into it.  zones lists the
+        // zone names in order with the index of their table in tables, or
+        // no_table.
+        struct tzdb_image {
+            static const std::size_t no_table = static_cast<std::size_t>(-1);
+
+            std::unique_ptr<mapped_file>                     file;
+            const unsigned char*                             data = nullptr;
+            std::size_t                                      size = 0;
+            std::vector<std::string>                         abbrevs;
+            std::vector<std::pair<std::string, std::size_t>> zones;
+            std::unique_ptr<detail::transition_table[]>      tables;
+
+            explicit tzdb_image(const std::string& path)
+                : file(new mapped_file(path, 0)) {
+                if (file->is_open()) {
+                    data = file->data();
+                    size = file->size();
                 }
             }
+
+            // data must be aligned to 8 bytes and outlive the image
+            tzdb_image(const unsigned char* d, std::size_t n)
+                : data(d)
+                , size(n) {
+            }
+        };
+
+    }  // unnamed namespace
+
+    // Hands the zones of db the tables image has for them.  The tables share
+    // ownership of image, which stays mapped for as long as any zone uses it.
+    static
+        void
+        map_image_tables(tzdb& db, const std::shared_ptr<const tzdb_image>& image) {
+        auto i = image->zones.begin();
+        for (auto& z : db.zones) {
+            while (i != image->zones.end() && i->first < z.name())
+                ++i;
+            if (i == image->zones.end())
+                break;
+            if (i->first == z.name() && i->second != tzdb_image::no_table)
+                z.map_table(std::shared_ptr<const detail::transition_table>(image,
+                    &image->tables[i->second]), detail::undocumented {});
         }
-#else  // !AUTO_DOWNLOAD
-        if (!file_exists(install)) {
-            std::string msg = "Timezone database not found at \"";
-            msg += install;
-            msg += "\"";
-            throw std::runtime_error(msg);
+    }
+
+    // Sorts and trims db once every region file has been parsed.  Zones copied
+    // from prev index prev's abbreviations, so db starts with the same ones.
+    // Likewise the tables of image index its abbreviations.
+    static
+        void
+        finish_tzdb(tzdb& db, const tzdb* prev = nullptr,
+            const std::shared_ptr<const tzdb_image>& image = nullptr) {
+        assert(prev == nullptr || image == nullptr);
+        std::sort(db.rules.begin(), db.rules.end());
+        Rule::split_overlaps(db.rules);
+        std::sort(db.zones.begin(), db.zones.end());
+        db.zones.shrink_to_fit();
+        db.strings.shrink_to_fit();
+        detail::abbrev_interner interner {db.abbrevs, {}};
+        if (prev != nullptr) {
+            for (auto const& a : prev->abbrevs)
+                interner.intern(a);
         }
-        db->version = get_version(path);
-#endif  // !AUTO_DOWNLOAD
+        if (image != nullptr) {
+            for (auto const& a : image->abbrevs)
+                interner.intern(a);
+        }
+        for (auto& z : db.zones)
+            z.intern_abbrevs(db.rules, db.strings, interner, detail::undocumented {});
+        db.abbrevs.shrink_to_fit();
+        if (image != nullptr)
+            map_image_tables(db, image);
+        for (auto& z : db.zones)
+            z.attach(db, detail::undocumented {});
+#if SHARE_TRANSITION_TABLES
+        // Mapped tables are shared between processes already
+        if (image == nullptr) {
+            detail::transition_registry tables;
+            for (auto& z : db.zones)
+                z.share_table(tables, detail::undocumented {});
+        }
+#endif
+        std::sort(db.links.begin(), db.links.end());
+        db.links.shrink_to_fit();
+        std::sort(db.leap_seconds.begin(), db.leap_seconds.end());
+        db.leap_seconds.shrink_to_fit();
+        build_zone_index(db);
+    }
 
-        CONSTDATA char* const files[] =
-        {
-            "africa", "antarctica", "asia", "australasia", "backward", "etcetera", "europe",
-            "pacificnew", "northamerica", "southamerica", "systemv", "leapseconds"
-        };
+    namespace {
 
-        for (const auto& filename : files) {
-            std::ifstream infile(path + filename);
-            while (infile) {
-                std::getline(infile, line);
-                if (!line.empty() && line[0] != '#') {
-                    std::istringstream in(line);
-                    std::string word;
-                    in >> word;
-                    if (word == "Rule") {
-                        db->rules.push_back(Rule(line));
-                        continue_zone = false;
-                    } else if (word == "Link") {
-                        db->links.push_back(time_zone_link(line));
-                        continue_zone = false;
-                    } else if (word == "Leap") {
-                        db->leap_seconds.push_back(leap_second(line, detail::undocumented {}));
-                        continue_zone = false;
-                    } else if (word == "Zone") {
-                        db->zones.push_back(time_zone(line, detail::undocumented {}));
-                        continue_zone = true;
-                    } else if (line[0] == '\t' && continue_zone) {
-                        db->zones.back().add(line);
-                    } else {
-                        std::cerr << line << '\n';
-                    }
-                }
+        // Read-only streambuf over a region file held in memory
+        struct memory_buf
+            : public std::streambuf {
+            memory_buf(const char* data, std::size_t size) {
+                auto p = const_cast<char*>(data);
+                setg(p, p, p + size);
             }
-        }
-        std::sort(db->rules.begin(), db->rules.end());
-        Rule::split_overlaps(db->rules);
-        std::sort(db->zones.begin(), db->zones.end());
-        db->zones.shrink_to_fit();
-        std::sort(db->links.begin(), db->links.end());
-        db->links.shrink_to_fit();
-        std::sort(db->leap_seconds.begin(), db->leap_seconds.end());
-        db->leap_seconds.shrink_to_fit();
+        };
 
-#ifdef _WIN32
-        std::string mapping_file = get_install() + folder_delimiter + "windowsZones.xml";
-        db->mappings = load_timezone_mappings_from_xml_file(mapping_file);
-        sort_zone_mappings(db->mappings);
-#endif // _WIN32
+    }  // unnamed namespace
 
-        return db;
+    // FNV-1a, to tell whether a region file changed between two loads, or a
+    // tzdb image since it was written
+    static
+        std::uint64_t
+        tzdata_hash(const unsigned char* p, std::size_t n) {
+        std::uint64_t h = 14695981039346656037ull;
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
     }
 
-    const tzdb&
-        reload_tzdb() {
-#if AUTO_DOWNLOAD
-        auto const& v = get_tzdb_list().front().version;
-        if (!v.empty() && v == remote_version())
-            return get_tzdb_list().front();
-#endif  // AUTO_DOWNLOAD
-        tzdb_list::undocumented_helper::push_front(get_tzdb_list(), init_tzdb().release());
-        return get_tzdb_list().front();
+    static
+        std::uint64_t
+        tzdata_hash(const std::string& s) {
+        return tzdata_hash(reinterpret_cast<const unsigned char*>(s.data()), s.size());
     }
 
-#endif  // !USE_OS_TZDB
-
-    const tzdb&
-        get_tzdb() {
-        return get_tzdb_list().front();
+    static
+        void
+        sort_names(std::vector<std::string>& v) {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
     }
 
-    const time_zone*
-#if HAS_STRING_VIEW
-        tzdb::locate_zone(std::string_view tz_name) const
-#else
-        tzdb::locate_zone(const std::string& tz_name) const
-#endif
-    {
-        auto zi = std::lower_bound(zones.begin(), zones.end(), tz_name,
-#if HAS_STRING_VIEW
-            [](const time_zone& z, const std::string_view& nm)
-#else
-            [](const time_zone& z, const std::string& nm)
-#endif
-            {
-                return z.name() < nm;
-            });
-        if (zi == zones.end() || zi->name() != tz_name) {
-#if !USE_OS_TZDB
-            auto li = std::lower_bound(links.begin(), links.end(), tz_name,
-#if HAS_STRING_VIEW
-                [](const time_zone_link& z, const std::string_view& nm)
-#else
-                [](const time_zone_link& z, const std::string& nm)
-#endif
-                {
-                    return z.name() < nm;
+    // Parses one region file into db and records what it defined
+    static
+        void
+        parse_region_file(tzdb& db, detail::string_interner& strings, const std::string& file,
+            const std::string& data, std::uint64_t hash) {
+        auto nz = db.zones.size();
+        auto nr = db.rules.size();
+        auto nl = db.links.size();
+        auto ns = db.leap_seconds.size();
+        memory_buf buf(data.data(), data.size());
+        std::istream in(&buf);
+        parse_tzdata(db, strings, in);
+        detail::tzdata_source src;
+        src.file = file;
+        src.hash = hash;
+        for (auto i = nz; i < db.zones.size(); ++i) {
+            src.zones.push_back(db.zones[i].name());
+            db.zones[i].used_rules(db.strings, src.uses, detail::undocumented {});
+        }
+        for (auto i = nr; i < db.rules.size(); ++i)
+            src.rules.push_back(db.strings[db.rules[i].name_id()]);
+        for (auto i = nl; i < db.links.size(); ++i)
+            src.links.push_back(db.links[i].name());
+        src.leap_seconds = db.leap_seconds.size() != ns;
+        sort_names(src.rules);
+        sort_names(src.uses);
+        db.sources.push_back(std::move(src));
+    }
+
+    // Copies what the unchanged region file src defined from prev, zones along
+    // with the work done on them there.  Their strings keep their indices, as
+    // db.strings starts out as a copy of prev.strings.
+    static
+        void
+        copy_region_file(tzdb& db, detail::string_interner& strings, const tzdb& prev,
+            const detail::tzdata_source& src) {
+        for (auto const& name : src.zones) {
+            auto z = std::lower_bound(prev.zones.begin(), prev.zones.end(), name,
+                [](const time_zone& x, const std::string& nm) {
+                    return x.name() < nm;
                 });
-            if (li != links.end() && li->name() == tz_name) {
-                zi = std::lower_bound(zones.begin(), zones.end(), li->target(),
-                    [](const time_zone& z, const std::string& nm) {
-                        return z.name() < nm;
-                    });
-                if (zi != zones.end() && zi->name() == li->target())
-                    return &*zi;
-            }
-#endif  // !USE_OS_TZDB
-            throw std::runtime_error(std::string(tz_name) + " not found in timezone database");
+            if (z != prev.zones.end() && z->name() == name)
+                db.zones.emplace_back(*z, detail::undocumented {});
+        }
+        for (auto const& name : src.rules) {
+            auto eqr = find_rules(prev.rules, strings.intern(name));
+            db.rules.insert(db.rules.end(), eqr.first, eqr.second);
+        }
+        for (auto const& name : src.links) {
+            auto l = std::lower_bound(prev.links.begin(), prev.links.end(), name,
+                [](const time_zone_link& x, const std::string& nm) {
+                    return x.name() < nm;
+                });
+            if (l != prev.links.end() && l->name() == name)
+                db.links.push_back(*l);
         }
-        return &*zi;
+        if (src.leap_seconds)
+            db.leap_seconds.insert(db.leap_seconds.end(), prev.leap_seconds.begin(),
+                prev.leap_seconds.end());
+        db.sources.push_back(src);
     }
 
-    const time_zone*
-#if HAS_STRING_VIEW
-        locate_zone(std::string_view tz_name)
-#else
-        locate_zone(const std::string& tz_name)
-#endif
-    {
-        return get_tzdb().locate_zone(tz_name);
+    // Parses the region files, given as name and contents, into db.  A file
+    // that hashes the same as when prev was built is copied from prev instead,
+    // unless one of its zones uses a rule that a parsed file defines now or
+    // defined then.
+    static
+        void
+        parse_region_files(tzdb& db,
+            const std::vector<std::pair<std::string, std::string>>& files,
+            const tzdb* prev) {
+        if (prev != nullptr)
+            db.strings = prev->strings;
+        detail::string_interner strings(db.strings);
+        auto n = files.size();
+        std::vector<std::uint64_t> hashes(n);
+        std::vector<const detail::tzdata_source*> old(n, nullptr);
+        std::vector<bool> parse(n, true);
+        for (std::size_t i = 0; i < n; ++i) {
+            hashes[i] = tzdata_hash(files[i].second);
+            if (prev == nullptr)
+                continue;
+            for (auto const& src : prev->sources) {
+                if (src.file == files[i].first) {
+                    old[i] = &src;
+                    parse[i] = src.hash != hashes[i];
+                }
+            }
+        }
+        std::vector<std::string> changed_rules;
+        std::vector<bool> parsed(n, false);
+        for (bool more = true; more;) {
+            more = false;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!parse[i] || parsed[i])
+                    continue;
+                parse_region_file(db, strings, files[i].first, files[i].second, hashes[i]);
+                parsed[i] = true;
+                auto const& now = db.sources.back().rules;
+                changed_rules.insert(changed_rules.end(), now.begin(), now.end());
+                if (old[i] != nullptr)
+                    changed_rules.insert(changed_rules.end(), old[i]->rules.begin(),
+                        old[i]->rules.end());
+            }
+            sort_names(changed_rules);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (parse[i])
+                    continue;
+                auto const& uses = old[i]->uses;
+                for (auto const& r : uses) {
+                    if (std::binary_search(changed_rules.begin(), changed_rules.end(), r)) {
+                        parse[i] = true;
+                        more = true;
+                        break;
+                    }
+                }
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!parse[i])
+                copy_region_file(db, strings, *prev, *old[i]);
+        }
     }
 
-#if USE_OS_TZDB
+    // tzdb image
 
-    std::ostream&
-        operator<<(std::ostream& os, const tzdb& db) {
-        os << "Version: " << db.version << "\n\n";
-        for (const auto& x : db.zones)
-            os << x << '\n';
-#if !MISSING_LEAP_SECONDS
-        os << '\n';
-        for (const auto& x : db.leap_seconds)
-            os << x << '\n';
-#endif  // !MISSING_LEAP_SECONDS
-        return os;
-    }
+    namespace {
+
+        // Place of an array in a tzdb image:  its offset from the start of the
+        // image, a multiple of 8, and its number of elements
+        struct image_span {
+            std::uint64_t offset;
+            std::uint64_t count;
+        };
+
+        struct image_file {
+            image_span name;
+            image_span text;
+        };
+
+        // A zone without a table has no transitions
+        struct image_zone {
+            image_span   name;
+            image_span   transitions;
+            image_span   index;
+            std::int64_t end;
+        };
+
+#ifdef _WIN32
+        struct image_mapping {
+            image_span other;
+            image_span territory;
+            image_span type;
+        };
+#endif  // _WIN32
+
+        // Everything is in the byte order and layout of the writer, which the
+        // reader checks for
+        struct image_header {
+            char          magic[8];
+            std::uint32_t format;
+            std::uint32_t byte_order;
+            std::int32_t  first_year;
+            std::int32_t  last_year;
+            std::uint64_t size;
+            std::uint64_t hash;  // tzdata_hash of everything after the header
+            image_span    version;
+            image_span    stamp;
+            image_span    files;
+            image_span    abbrevs;
+            image_span    zones;
+            image_span    mappings;
+        };
+
+        CONSTDATA char image_magic[] = "TZDBIMG";
+        CONSTDATA std::uint32_t image_format = 2;
+        CONSTDATA std::uint32_t image_byte_order = 0x01020304;
+
+    }  // unnamed namespace
+
+    static_assert(sizeof(image_header) == 136, "");
+    static_assert(sizeof(image_zone) == 56, "");
+
+    // Lays out db, parsed from files, as a tzdb image, building every table
+    // first
+    static
+        std::string
+        build_tzdb_image(const tzdb& db,
+            const std::vector<std::pair<std::string, std::string>>& files,
+            const std::string& stamp) {
+        prefetch_zones(db);
+        std::string out(sizeof(image_header), '\0');
+        auto put = [&out](const void* data, std::size_t bytes, std::size_t count) {
+            out.resize((out.size() + 7) / 8 * 8, '\0');
+            image_span s {out.size(), count};
+            out.append(static_cast<const char*>(data), bytes);
+            return s;
+        };
+        auto put_string = [&put](const std::string& str) {
+            return put(str.data(), str.size(), str.size());
+        };
+        image_header h {};
+        std::memcpy(h.magic, image_magic, sizeof(h.magic));
+        h.format = image_format;
+        h.byte_order = image_byte_order;
+        h.first_year = static_cast<int>(transition_first_year);
+        h.last_year = static_cast<int>(transition_last_year);
+        h.version = put_string(db.version);
+        h.stamp = put_string(stamp);
+        std::vector<image_file> image_files;
+        for (auto const& f : files)
+            image_files.push_back({put_string(f.first), put_string(f.second)});
+        h.files = put(image_files.data(), image_files.size() * sizeof(image_file),
+            image_files.size());
+        std::vector<image_span> abbrevs;
+        for (auto const& a : db.abbrevs)
+            abbrevs.push_back(put_string(a));
+        h.abbrevs = put(abbrevs.data(), abbrevs.size() * sizeof(image_span), abbrevs.size());
+        // Zones with equal tables refer to one copy
+        std::map<const detail::transition_table*, std::pair<image_span, image_span>,
+            detail::transition_registry::less> tables;
+        std::vector<image_zone> zones;
+        for (auto const& z : db.zones) {
+            image_zone iz {};
+            iz.name = put_string(z.name());
+            if (auto t = z.get_table(detail::undocumented {})) {
+                auto i = tables.find(t);
+                if (i == tables.end()) {
+                    auto transitions = put(t->transitions.begin(),
+                        t->transitions.size() * sizeof(detail::zone_transition),
+                        t->transitions.size());
+                    auto index = put(t->index.begin(), t->index.size() * sizeof(std::uint16_t),
+                        t->index.size());
+                    i = tables.emplace(t, std::make_pair(transitions, index)).first;
+                }
+                iz.transitions = i->second.first;
+                iz.index = i->second.second;
+                iz.end = t->end.time_since_epoch().count();
+            }
+            zones.push_back(iz);
+        }
+        h.zones = put(zones.data(), zones.size() * sizeof(image_zone), zones.size());
+#ifdef _WIN32
+        std::vector<image_mapping> mappings;
+        for (auto const& m : db.mappings)
+            mappings.push_back({put_string(m.other), put_string(m.territory),
+                put_string(m.type)});
+        h.mappings = put(mappings.data(), mappings.size() * sizeof(image_mapping),
+            mappings.size());
+#endif  // _WIN32
+        h.size = out.size();
+        h.hash = tzdata_hash(reinterpret_cast<const unsigned char*>(out.data()) + sizeof(h),
+            out.size() - sizeof(h));
+        std::memcpy(&out[0], &h, sizeof(h));
+        return out;
+    }
+
+#if !EMBEDDED_TZDB
+
+    // Writes db, parsed from files, as a tzdb image at path.  Failing to is
+    // not an error:  the next process to load the database builds its own and
+    // tries again.  On Windows an image that is mapped by another process can
+    // not be replaced.
+    static
+        void
+        write_tzdb_image(const tzdb& db,
+            const std::vector<std::pair<std::string, std::string>>& files,
+            const std::string& stamp, const std::string& path) {
+        auto out = build_tzdb_image(db, files, stamp);
+#ifdef _WIN32
+        auto temp = path + '.' + std::to_string(::GetCurrentProcessId());
+#else  // !_WIN32
+        auto temp = path + '.' + std::to_string(::getpid());
+#endif  // !_WIN32
+        std::ofstream f(temp, std::ios::binary);
+        f.write(out.data(), static_cast<std::streamsize>(out.size()));
+        f.close();
+#ifndef _WIN32
+        // Readers refuse an image others can write to, whatever the umask is
+        ::chmod(temp.c_str(), 0644);
+#endif  // !_WIN32
+#ifdef _WIN32
+        bool moved = f && ::MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else  // !_WIN32
+        bool moved = f && std::rename(temp.c_str(), path.c_str()) == 0;
+#endif  // !_WIN32
+        if (!moved)
+            std::remove(temp.c_str());
+    }
+
+#endif  // !EMBEDDED_TZDB
+
+    // Builds a tzdb from image, whose data is in place.  Returns null if it is
+    // damaged, was written by a build with other table years or layout, or its
+    // stamp is other than stamp.  An empty stamp takes any image.
+    static
+        std::unique_ptr<tzdb>
+        load_tzdb_image(const std::shared_ptr<tzdb_image>& image, const std::string& stamp) {
+        using namespace date;
+        auto base = image->data;
+        auto image_size = image->size;
+        if (base == nullptr || image_size < sizeof(image_header))
+            return nullptr;
+        image_header h;
+        std::memcpy(&h, base, sizeof(h));
+        if (std::memcmp(h.magic, image_magic, sizeof(h.magic)) != 0 ||
+            h.format != image_format || h.byte_order != image_byte_order ||
+            h.first_year != static_cast<int>(transition_first_year) ||
+            h.last_year != static_cast<int>(transition_last_year) ||
+            h.size != image_size ||
+            h.hash != tzdata_hash(base + sizeof(h), image_size - sizeof(h)))
+            return nullptr;
+        // Whether s holds its elements of size bytes inside of the image
+        auto fits = [image_size](const image_span& s, std::size_t size) {
+            return s.offset % 8 == 0 && s.offset <= image_size &&
+                s.count <= (image_size - s.offset) / size;
+        };
+        auto str = [base](const image_span& s) {
+            return std::string(reinterpret_cast<const char*>(base + s.offset),
+                static_cast<std::size_t>(s.count));
+        };
+        if (!fits(h.version, 1) || !fits(h.stamp, 1) || !fits(h.files, sizeof(image_file)) ||
+            !fits(h.abbrevs, sizeof(image_span)) || !fits(h.zones, sizeof(image_zone)))
+            return nullptr;
+        if (!stamp.empty() && str(h.stamp) != stamp)
+            return nullptr;
+
+        std::vector<std::pair<std::string, std::string>> files;
+        auto image_files = reinterpret_cast<const image_file*>(base + h.files.offset);
+        for (std::size_t i = 0; i < h.files.count; ++i) {
+            auto const& f = image_files[i];
+            if (!fits(f.name, 1) || !fits(f.text, 1))
+                return nullptr;
+            files.emplace_back(str(f.name), str(f.text));
+        }
+        if (h.abbrevs.count >= no_abbrev)
+            return nullptr;
+        auto abbrevs = reinterpret_cast<const image_span*>(base + h.abbrevs.offset);
+        for (std::size_t i = 0; i < h.abbrevs.count; ++i) {
+            if (!fits(abbrevs[i], 1))
+                return nullptr;
+            image->abbrevs.push_back(str(abbrevs[i]));
+        }
+        {
+            auto sorted = image->abbrevs;
+            std::sort(sorted.begin(), sorted.end());
+            if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+                return nullptr;
+        }
+
+        // Lookups trust the tables, so check everything find_transition relies on
+        const sys_seconds first = sys_days(transition_first_year / min_day);
+        const sys_seconds last = sys_days((transition_last_year + years {1}) / min_day);
+        std::size_t buckets = 0;
+        for (auto t = first; t < last; t += transition_bucket)
+            ++buckets;
+        auto valid_table = [&](const image_zone& z) {
+            if (!fits(z.transitions, sizeof(detail::zone_transition)) ||
+                !fits(z.index, sizeof(std::uint16_t)) ||
+                z.transitions.count > std::numeric_limits<std::uint16_t>::max() ||
+                z.index.count != buckets)
+                return false;
+            auto tr = reinterpret_cast<const detail::zone_transition*>(base + z.transitions.offset);
+            auto ix = reinterpret_cast<const std::uint16_t*>(base + z.index.offset);
+            for (std::size_t i = 0; i < z.transitions.count; ++i) {
+                if (tr[i].abbrev >= h.abbrevs.count || (i > 0 && !(tr[i - 1].begin < tr[i].begin)))
+                    return false;
+            }
+            for (std::size_t b = 0; b < buckets; ++b) {
+                if (ix[b] >= z.transitions.count || (b > 0 && ix[b] < ix[b - 1]))
+                    return false;
+            }
+            return true;
+        };
+        auto image_zones = reinterpret_cast<const image_zone*>(base + h.zones.offset);
+        std::map<std::uint64_t, std::size_t> table_at;
+        std::vector<const image_zone*> owners;
+        for (std::size_t i = 0; i < h.zones.count; ++i) {
+            auto const& z = image_zones[i];
+            if (!fits(z.name, 1))
+                return nullptr;
+            auto t = tzdb_image::no_table;
+            if (z.transitions.count != 0) {
+                auto k = table_at.find(z.transitions.offset);
+                if (k == table_at.end()) {
+                    if (!valid_table(z))
+                        return nullptr;
+                    k = table_at.emplace(z.transitions.offset, owners.size()).first;
+                    owners.push_back(&z);
+                }
+                t = k->second;
+            }
+            image->zones.emplace_back(str(z.name), t);
+            if (i > 0 && !(image->zones[i - 1].first < image->zones[i].first))
+                return nullptr;
+        }
+        image->tables.reset(new detail::transition_table[owners.size()]);
+        for (std::size_t k = 0; k < owners.size(); ++k) {
+            auto const& z = *owners[k];
+            auto& t = image->tables[k];
+            t.transitions = {reinterpret_cast<const detail::zone_transition*>(
+                base + z.transitions.offset), static_cast<std::size_t>(z.transitions.count)};
+            t.index = {reinterpret_cast<const std::uint16_t*>(base + z.index.offset),
+                static_cast<std::size_t>(z.index.count)};
+            t.end = sys_seconds {std::chrono::seconds {z.end}};
+        }
+
+        std::unique_ptr<tzdb> db(new tzdb);
+        db->version = str(h.version);
+        try {
+            parse_region_files(*db, files, nullptr);
+            finish_tzdb(*db, nullptr, image);
+        } catch (...) {
+            return nullptr;
+        }
+#ifdef _WIN32
+        if (!fits(h.mappings, sizeof(image_mapping)))
+            return nullptr;
+        auto mappings = reinterpret_cast<const image_mapping*>(base + h.mappings.offset);
+        for (std::size_t i = 0; i < h.mappings.count; ++i) {
+            auto const& m = mappings[i];
+            if (!fits(m.other, 1) || !fits(m.territory, 1) || !fits(m.type, 1))
+                return nullptr;
+            db->mappings.emplace_back();
+            db->mappings.back().other = str(m.other);
+            db->mappings.back().territory = str(m.territory);
+            db->mappings.back().type = str(m.type);
+        }
+#endif  // _WIN32
+        return db;
+    }
+
+#if !EMBEDDED_TZDB
+
+    // Maps the tzdb image at path and builds a tzdb from it, as above.  Returns
+    // null if there is no image.  So that another user can't plant one, the
+    // image must belong to this user and be writable by no one else.
+    static
+        std::unique_ptr<tzdb>
+        load_tzdb_image(const std::string& path, const std::string& stamp) {
+        auto image = std::make_shared<tzdb_image>(path);
+        if (!image->file->is_open() || !image->file->is_private())
+            return nullptr;
+        return load_tzdb_image(image, stamp);
+    }
+
+#endif  // !EMBEDDED_TZDB
+
+    std::string
+        detail::make_tzdb_image(const std::string& version,
+            const std::vector<std::pair<std::string, std::string>>& files) {
+        tzdb db;
+        db.version = version;
+        std::vector<std::pair<std::string, std::string>> regions;
+        for (auto const& f : files) {
+            if (f.first != "windowsZones.xml")
+                regions.push_back(f);
+        }
+        parse_region_files(db, regions, nullptr);
+        finish_tzdb(db);
+#ifdef _WIN32
+        for (auto const& f : files) {
+            if (f.first == "windowsZones.xml") {
+                memory_buf buf(f.second.data(), f.second.size());
+                std::istream in(&buf);
+                db.mappings = load_timezone_mappings_from_xml(in, f.first);
+                sort_zone_mappings(db.mappings);
+            }
+        }
+#endif  // _WIN32
+        return build_tzdb_image(db, regions, version);
+    }
+
+#if EMBEDDED_TZDB
+
+    // The tables were built along with the image when the program was, so only
+    // the text is parsed here
+    static
+        std::unique_ptr<tzdb>
+        init_tzdb(const tzdb*) {
+        using namespace date;
+        auto image = std::make_shared<tzdb_image>(embedded_tzdb_image, embedded_tzdb_image_size);
+        auto db = load_tzdb_image(image, embedded_tzdata_version);
+        if (db == nullptr)
+            throw std::runtime_error("The embedded tzdb image was not generated by this build of tz.cpp");
+        return db;
+    }
+
+#else  // !EMBEDDED_TZDB
+
+#if HAS_ZLIB
+
+    // Builds db from the region files in the gzipped tar archive at path,
+    // reusing what it can from prev, and returns those files.  On Windows the
+    // mappings come from windowsZones.xml in the archive or, as IANA releases
+    // don't have one, beside it.
+    static
+        std::vector<std::pair<std::string, std::string>>
+        load_tar_gz(tzdb& db, const std::string& path, const tzdb* prev) {
+        std::map<std::string, std::string> files;
+        for_each_tar_gz_file(path, [](const std::string& name) {
+                return name == "version" || name == "windowsZones.xml" ||
+                    std::find_if(std::begin(tzdata_files), std::end(tzdata_files),
+                        [&name](const char* f) {return name == f;}) != std::end(tzdata_files);
+            }, [&files](const std::string& name, std::string& data) {
+                files[name] = std::move(data);
+        });
+        auto v = files.find("version");
+        if (v != files.end()) {
+            std::istringstream in(v->second);
+            in >> db.version;
+        }
+        std::vector<std::pair<std::string, std::string>> regions;
+        for (const auto& filename : tzdata_files) {
+            auto i = files.find(filename);
+            if (i != files.end())
+                regions.emplace_back(filename, std::move(i->second));
+        }
+        parse_region_files(db, regions, prev);
+        finish_tzdb(db, prev);
+
+#ifdef _WIN32
+        auto m = files.find("windowsZones.xml");
+        if (m != files.end()) {
+            memory_buf buf(m->second.data(), m->second.size());
+            std::istream in(&buf);
+            db.mappings = load_timezone_mappings_from_xml(in, path);
+        } else {
+            auto mapping_file = path.substr(0, path.find_last_of("\\/") + 1);
+            mapping_file += "windowsZones.xml";
+            db.mappings = load_timezone_mappings_from_xml_file(mapping_file);
+        }
+        sort_zone_mappings(db.mappings);
+#endif // _WIN32
+        return regions;
+    }
+
+#endif  // HAS_ZLIB
+
+    // What an image built from the install is checked against:  the version
+    // of a folder, or the size and modification time of an archive, which
+    // would have to be unpacked to learn its version.
+    static
+        std::string
+        install_stamp(const std::string& install) {
+        if (is_archive_install(install)) {
+            struct stat st;
+            if (::stat(install.c_str(), &st) != 0)
+                return std::string();
+            return std::to_string(st.st_size) + ' ' + std::to_string(st.st_mtime);
+        }
+        return get_version(install + folder_delimiter);
+    }
+
+    // Region files that are the same as when prev was loaded are not parsed
+    // again, see parse_region_files.
+    static
+        std::unique_ptr<tzdb>
+        init_tzdb(const tzdb* prev) {
+        using namespace date;
+        const std::string install = get_install();
+        const std::string path = install + folder_delimiter;
+
+        // An image built from the install as it is now, or any image while
+        // nothing is installed, stands in for building the database
+        auto const& image = get_tzdb_image();
+        if (!image.empty()) {
+            std::lock_guard<std::mutex> lock(get_install_mutex());
+            auto installed = file_exists(install);
+            std::string stamp;
+            try {
+                if (installed)
+                    stamp = install_stamp(install);
+            } catch (const std::exception&) {
+            }
+            if (!installed || !stamp.empty()) {
+                if (auto db = load_tzdb_image(image, stamp))
+                    return db;
+            }
+        }
+
+        std::unique_ptr<tzdb> db(new tzdb);
+
+#if AUTO_DOWNLOAD
+        // With nothing installed there is nothing to serve, so this one download
+        // is waited for.  Otherwise newer versions come from start_tzdb_update.
+        if (!file_exists(install)) {
+            auto rv = remote_version();
+            if (!rv.empty() && remote_download(rv)) {
+                if (!remote_install(rv)) {
+                    std::string msg = "Timezone database version \"";
+                    msg += rv;
+                    msg += "\" did not install correctly to \"";
+                    msg += install;
+                    msg += "\"";
+                    throw std::runtime_error(msg);
+                }
+            }
+            if (!file_exists(install)) {
+                std::string msg = "Timezone database not found at \"";
+                msg += install;
+                msg += "\"";
+                throw std::runtime_error(msg);
+            }
+        }
+#else  // !AUTO_DOWNLOAD
+        if (!file_exists(install)) {
+            std::string msg = "Timezone database not found at \"";
+            msg += install;
+            msg += "\"";
+            throw std::runtime_error(msg);
+        }
+#endif  // !AUTO_DOWNLOAD
+
+        std::vector<std::pair<std::string, std::string>> files;
+        std::string stamp;
+        {
+            std::lock_guard<std::mutex> lock(get_install_mutex());
+#if HAS_ZLIB
+            if (is_archive_install(install)) {
+                files = load_tar_gz(*db, install, prev);
+                stamp = install_stamp(install);
+            } else
+#endif  // HAS_ZLIB
+            {
+                db->version = get_version(path);
+                for (const auto& filename : tzdata_files) {
+                    std::ifstream infile(path + filename);
+                    files.emplace_back(filename,
+                        std::string(std::istreambuf_iterator<char>(infile),
+                            std::istreambuf_iterator<char>()));
+                }
+                parse_region_files(*db, files, prev);
+                finish_tzdb(*db, prev);
+
+#ifdef _WIN32
+                std::string mapping_file = get_install() + folder_delimiter + "windowsZones.xml";
+                db->mappings = load_timezone_mappings_from_xml_file(mapping_file);
+                sort_zone_mappings(db->mappings);
+#endif // _WIN32
+                stamp = db->version;
+            }
+        }
+
+        // Building every table for the image takes a while, so the install is
+        // not kept locked meanwhile
+        if (!image.empty())
+            write_tzdb_image(*db, files, stamp, image);
+        return db;
+    }
+
+#endif  // !EMBEDDED_TZDB
+
+    const tzdb&
+        reload_tzdb() {
+#if EMBEDDED_TZDB
+        // The embedded tables can not change while the program runs
+        return get_tzdb_list().front();
+#else  // !EMBEDDED_TZDB
+#if AUTO_DOWNLOAD
+        auto const& v = get_tzdb_list().front().version;
+        auto rv = remote_version();
+        if (!v.empty() && v == rv)
+            return get_tzdb_list().front();
+        if (!rv.empty() && remote_download(rv))
+            remote_install(rv);
+#endif  // AUTO_DOWNLOAD
+        std::unique_ptr<tzdb> db;
+        {
+            tzdb_snapshot prev;
+            db = init_tzdb(&*prev);
+        }
+        publish_tzdb(std::move(db));
+        return get_tzdb_list().front();
+#endif  // !EMBEDDED_TZDB
+    }
+
+    // tzdb refresh
+
+#if !EMBEDDED_TZDB
+
+    namespace {
+
+        struct tzdb_refresher {
+            std::mutex              control;  // serializes start and stop
+            std::mutex              mutex;
+            std::condition_variable cv;
+            tzdb_refresh_options    options;
+            unsigned                generation = 0;
+            bool                    stop = false;
+            std::thread             thread;
+
+            ~tzdb_refresher() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stop = true;
+                }
+                cv.notify_all();
+#if AUTO_DOWNLOAD
+                stop_remote();
+#endif  // AUTO_DOWNLOAD
+                if (thread.joinable())
+                    thread.join();
+            }
+        };
+
+    }  // unnamed namespace
+
+    static
+        tzdb_refresher&
+        get_tzdb_refresher() {
+        // Constructed after, and so destroyed before, the tzdb_list and
+        // everything else the thread uses
+        get_tzdb_list();
+        get_tzdb_publisher();
+        get_install_mutex();
+#if AUTO_DOWNLOAD
+        get_remote_settings();
+#endif  // AUTO_DOWNLOAD
+        static tzdb_refresher refresher;
+        return refresher;
+    }
+
+    // Builds and publishes a new tzdb if the version it would have differs
+    // from the front of the list, first installing the remote version if
+    // that differs.
+    static
+        void
+        refresh_tzdb() {
+        auto const& v = get_tzdb_list().front().version;
+#if AUTO_DOWNLOAD
+        // Each step is left out once stop_remote has been called
+        auto rv = remote_version();
+        if (rv.empty() || rv == v || remote_stopped())
+            return;
+        if (!remote_download(rv) || remote_stopped() || !remote_install(rv) || remote_stopped())
+            return;
+#endif  // AUTO_DOWNLOAD
+        {
+            // An archive has to be read to learn its version, which is left to
+            // init_tzdb below
+            std::lock_guard<std::mutex> lock(get_install_mutex());
+            auto const& install = get_install();
+            if (!is_archive_install(install) && get_version(install + folder_delimiter) == v)
+                return;
+        }
+        std::unique_ptr<tzdb> db;
+        {
+            tzdb_snapshot prev;
+            db = init_tzdb(&*prev);
+        }
+        if (db->version != v)
+            publish_tzdb(std::move(db));
+    }
+
+    // How often the refresher retries reclaiming tzdbs that are still held
+    CONSTDATA auto tzdb_reclaim_period = std::chrono::seconds {10};
+
+    // Reclaims what it can of the retired tzdbs and returns whether any are left
+    static
+        bool
+        reclaim_retired_tzdbs() {
+        auto& publisher = get_tzdb_publisher();
+        std::lock_guard<std::mutex> lock(publisher.mutex);
+        reclaim_tzdbs(publisher);
+        return !publisher.retired.empty();
+    }
+
+    // Readers only ever give up their hold on a tzdb, so it is this thread,
+    // not theirs, that deletes the ones they let go of.
+    static
+        void
+        run_tzdb_refresh(tzdb_refresher& r) {
+        using namespace std::chrono;
+        std::unique_lock<std::mutex> lock(r.mutex);
+        auto next = steady_clock::now() + r.options.interval;
+        // Whatever was retired before the thread started is retried too
+        bool retired = true;
+        while (!r.stop) {
+            auto g = r.generation;
+            auto until = retired ? std::min(next, steady_clock::now() + tzdb_reclaim_period) :
+                next;
+            if (r.cv.wait_until(lock, until, [&r, g]() {return r.stop || r.generation != g;})) {
+                // New options start a new interval
+                next = steady_clock::now() + r.options.interval;
+                continue;
+            }
+            auto interval = r.options.interval;
+            lock.unlock();
+            if (steady_clock::now() >= next) {
+                try {
+                    refresh_tzdb();
+                } catch (...) {
+                    // Keep the current tzdb and try again next time
+                }
+                next = steady_clock::now() + interval;
+            }
+            retired = reclaim_retired_tzdbs();
+            lock.lock();
+        }
+    }
+
+#if AUTO_DOWNLOAD
+
+    namespace {
+
+        struct tzdb_updater {
+            std::mutex              mutex;
+            std::condition_variable cv;
+            bool                    done = false;
+            std::thread             thread;
+
+            ~tzdb_updater() {
+                // The request in progress is aborted and the steps after it
+                // left out, so this waits out at most a second or so of
+                // transfer, or an install or parse already under way
+                stop_remote();
+                if (thread.joinable())
+                    thread.join();
+            }
+        };
+
+    }  // unnamed namespace
+
+    static
+        tzdb_updater&
+        get_tzdb_updater() {
+        static tzdb_updater updater;
+        return updater;
+    }
+
+    static
+        void
+        run_tzdb_update(tzdb_updater& u) {
+        try {
+            refresh_tzdb();
+        } catch (...) {
+            // Keep serving the installed version
+        }
+        {
+            std::lock_guard<std::mutex> lock(u.mutex);
+            u.done = true;
+        }
+        u.cv.notify_all();
+    }
+
+    // Called once the first tzdb is in place.  Everything the thread uses is
+    // constructed here first, so that it all outlives the updater.
+    static
+        void
+        start_tzdb_update() {
+        get_tzdb_publisher();
+        get_remote_settings();
+        get_install_mutex();
+        auto& u = get_tzdb_updater();
+        u.thread = std::thread(run_tzdb_update, std::ref(u));
+    }
+
+    bool
+        wait_tzdb_update(std::chrono::milliseconds timeout) {
+        get_tzdb_list();
+        auto& u = get_tzdb_updater();
+        std::unique_lock<std::mutex> lock(u.mutex);
+        return u.cv.wait_for(lock, timeout, [&u]() {return u.done;});
+    }
+
+#endif  // AUTO_DOWNLOAD
+
+#endif  // !EMBEDDED_TZDB
+
+    void
+        start_tzdb_refresh(const tzdb_refresh_options& options) {
+        // The embedded tables can not change, so there is nothing to refresh
+#if !EMBEDDED_TZDB
+        {
+            auto& publisher = get_tzdb_publisher();
+            std::lock_guard<std::mutex> lock(publisher.mutex);
+            publisher.reclaim = options.reclaim;
+        }
+        auto& r = get_tzdb_refresher();
+        std::lock_guard<std::mutex> control(r.control);
+        {
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.options = options;
+            r.stop = false;
+            ++r.generation;
+        }
+        if (r.thread.joinable())
+            r.cv.notify_all();
+        else
+            r.thread = std::thread(run_tzdb_refresh, std::ref(r));
+#else  // EMBEDDED_TZDB
+        (void)options;
+#endif  // EMBEDDED_TZDB
+    }
+
+    void
+        stop_tzdb_refresh() {
+#if !EMBEDDED_TZDB
+        auto& r = get_tzdb_refresher();
+        std::lock_guard<std::mutex> control(r.control);
+        {
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.stop = true;
+        }
+        r.cv.notify_all();
+        if (r.thread.joinable())
+            r.thread.join();
+#endif  // !EMBEDDED_TZDB
+    }
+
+#endif  // !USE_OS_TZDB
+
+    const tzdb&
+        get_tzdb() {
+        return get_tzdb_list().front();
+    }
+
+    const time_zone*
+#if HAS_STRING_VIEW
+        tzdb::locate_zone(std::string_view tz_name) const
+#else
+        tzdb::locate_zone(const std::string& tz_name) const
+#endif
+    {
+        const time_zone* zone;
+        if (try_locate_zone(tz_name, zone) != tz_status::ok)
+            throw std::runtime_error(std::string(tz_name) + " not found in timezone database");
+        return zone;
+    }
+
+    tz_status
+#if HAS_STRING_VIEW
+        tzdb::try_locate_zone(std::string_view tz_name, const time_zone*& zone) const NOEXCEPT
+#else
+        tzdb::try_locate_zone(const std::string& tz_name, const time_zone*& zone) const NOEXCEPT
+#endif
+    {
+        zone = nullptr;
+        if (!name_index.empty()) {
+            auto s = find_zone_slot(name_index, tz_name.data(), tz_name.size(), false);
+            if (s == nullptr)
+                return tz_status::not_found;
+            zone = s->zone;
+            return tz_status::ok;
+        }
+        auto zi = std::lower_bound(zones.begin(), zones.end(), tz_name,
+#if HAS_STRING_VIEW
+            [](const time_zone& z, const std::string_view& nm)
+#else
+            [](const time_zone& z, const std::string& nm)
+#endif
+            {
+                return z.name() < nm;
+            });
+        if (zi == zones.end() || zi->name() != tz_name) {
+#if !USE_OS_TZDB
+            auto li = std::lower_bound(links.begin(), links.end(), tz_name,
+#if HAS_STRING_VIEW
+                [](const time_zone_link& z, const std::string_view& nm)
+#else
+                [](const time_zone_link& z, const std::string& nm)
+#endif
+                {
+                    return z.name() < nm;
+                });
+            if (li != links.end() && li->name() == tz_name) {
+                zi = std::lower_bound(zones.begin(), zones.end(), li->target(),
+                    [](const time_zone& z, const std::string& nm) {
+                        return z.name() < nm;
+                    });
+                if (zi != zones.end() && zi->name() == li->target()) {
+                    zone = &*zi;
+                    return tz_status::ok;
+                }
+            }
+#endif  // !USE_OS_TZDB
+            return tz_status::not_found;
+        }
+        zone = &*zi;
+        return tz_status::ok;
+    }
+
+    zone_match
+#if HAS_STRING_VIEW
+        tzdb::find_zone(std::string_view tz_name, bool ignore_case) const NOEXCEPT
+#else
+        tzdb::find_zone(const std::string& tz_name, bool ignore_case) const NOEXCEPT
+#endif
+    {
+        zone_match m;
+        auto s = find_zone_slot(ignore_case ? name_index_nocase : name_index,
+            tz_name.data(), tz_name.size(), ignore_case);
+        if (s != nullptr) {
+            m.name = s->name;
+            m.zone = s->zone;
+        }
+        return m;
+    }
+
+    // Walking every zone means initializing every zone, so the abbreviation
+    // index is filled in once, when it is first needed, rather than at load.
+    struct detail::abbrev_index {
+        // The intervals of one abbreviation, a run per zone, and where each
+        // run starts followed by the end of the last one
+        struct uses {
+            std::vector<abbrev_zone> intervals;
+            std::vector<std::size_t> runs;
+        };
+
+        std::once_flag                        once;
+        std::unordered_map<std::string, uses> zones;
+    };
+
+    // Past this year the abbreviations of a zone repeat with its rules, so the
+    // index stops there and locate_abbrev asks the zones themselves.
+    CONSTDATA auto abbrev_index_last_year = date::year {2100};
+
+#if USE_OS_TZDB
+
+    // The zones zone1970.tab lists, which leaves out the names kept for
+    // backward compatibility.  Empty if it can't be read.
+    static
+        std::set<std::string>
+        canonical_zones() {
+        std::set<std::string> names;
+        std::ifstream in(get_tz_dir() + "/zone1970.tab");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream fields(line);
+            std::string codes, coordinates, name;
+            if (fields >> codes >> coordinates >> name)
+                names.insert(name);
+        }
+        return names;
+    }
+
+#endif  // USE_OS_TZDB
+
+    static
+        void
+        build_abbrev_index(const tzdb& db, detail::abbrev_index& index) {
+        using namespace date;
+        const sys_seconds last = sys_days(abbrev_index_last_year / min_day);
+        std::unordered_map<std::string, std::vector<std::vector<abbrev_zone>>> runs;
+        std::vector<std::pair<std::string, std::vector<abbrev_zone>>> uses;
+        for (auto const& z : db.zones) {
+            // The intervals of this zone by abbreviation, merged where they adjoin
+            uses.clear();
+            auto x = z.get_info(sys_days(min_year / min_day));
+            while (true) {
+                auto u = std::find_if(uses.begin(), uses.end(),
+                    [&x](const std::pair<std::string, std::vector<abbrev_zone>>& a) {
+                        return a.first == x.abbrev;
+                    });
+                if (u == uses.end())
+                    u = uses.insert(uses.end(), {x.abbrev, {}});
+                auto& v = u->second;
+                if (!v.empty() && v.back().end == x.begin && v.back().offset == x.offset)
+                    v.back().end = x.end;
+                else
+                    v.push_back(abbrev_zone {&z, x.offset, x.begin, x.end});
+                if (x.end >= last)
+                    break;
+                x = z.get_info(x.end);
+            }
+            for (auto& u : uses) {
+                u.second.shrink_to_fit();
+                runs[u.first].push_back(std::move(u.second));
+            }
+        }
+        // Zones named after a place come first, before the names kept for
+        // backward compatibility and then CET, EST5EDT and the like, which use
+        // their abbreviations since the start of time.  Of those, one named
+        // after the abbreviation itself goes first, as Etc/UTC does for UTC.
+#if USE_OS_TZDB
+        const auto canonical = canonical_zones();
+#endif
+        auto rank = [&](const time_zone* z) {
+            if (z->name().find('/') == std::string::npos ||
+                z->name().compare(0, 4, "Etc/") == 0)
+                return 2;
+#if USE_OS_TZDB
+            if (!canonical.empty() && canonical.count(z->name()) == 0)
+                return 1;
+#endif
+            return 0;
+        };
+        for (auto& r : runs) {
+            auto const& abbrev = r.first;
+            auto named = [&abbrev](const time_zone* z) {
+                auto const& n = z->name();
+                return n == abbrev ||
+                    (n.compare(0, 4, "Etc/") == 0 && n.compare(4, n.npos, abbrev) == 0);
+            };
+            std::stable_sort(r.second.begin(), r.second.end(),
+                [&](const std::vector<abbrev_zone>& a, const std::vector<abbrev_zone>& b) {
+                    auto ra = rank(a.front().zone);
+                    auto rb = rank(b.front().zone);
+                    if (ra != rb)
+                        return ra < rb;
+                    if (named(a.front().zone) != named(b.front().zone))
+                        return named(a.front().zone);
+                    return a.front().begin < b.front().begin;
+                });
+            auto& u = index.zones[r.first];
+            for (auto const& v : r.second) {
+                u.runs.push_back(u.intervals.size());
+                u.intervals.insert(u.intervals.end(), v.begin(), v.end());
+            }
+            u.runs.push_back(u.intervals.size());
+            u.intervals.shrink_to_fit();
+            u.runs.shrink_to_fit();
+        }
+    }
+
+    static
+        const detail::abbrev_index::uses*
+        find_abbrev_uses(const tzdb& db, const std::string& abbrev) {
+        if (db.abbrev_index == nullptr)
+            return nullptr;
+        std::call_once(db.abbrev_index->once, [&db] {
+            build_abbrev_index(db, *db.abbrev_index);
+        });
+        auto i = db.abbrev_index->zones.find(abbrev);
+        return i != db.abbrev_index->zones.end() ? &i->second : nullptr;
+    }
+
+    const std::vector<abbrev_zone>&
+#if HAS_STRING_VIEW
+        tzdb::find_abbrev(std::string_view abbrev) const
+#else
+        tzdb::find_abbrev(const std::string& abbrev) const
+#endif
+    {
+        static const std::vector<abbrev_zone> none;
+        auto u = find_abbrev_uses(*this, std::string(abbrev));
+        return u != nullptr ? u->intervals : none;
+    }
+
+    const time_zone*
+#if HAS_STRING_VIEW
+        tzdb::locate_abbrev(std::string_view abbrev, sys_seconds tp) const
+#else
+        tzdb::locate_abbrev(const std::string& abbrev, sys_seconds tp) const
+#endif
+    {
+        using namespace date;
+        auto u = find_abbrev_uses(*this, std::string(abbrev));
+        if (u == nullptr)
+            return nullptr;
+        const sys_seconds last = sys_days(abbrev_index_last_year / min_day);
+        auto const& intervals = u->intervals;
+        for (std::size_t k = 0; k + 1 < u->runs.size(); ++k) {
+            auto b = intervals.begin() + static_cast<std::ptrdiff_t>(u->runs[k]);
+            auto e = intervals.begin() + static_cast<std::ptrdiff_t>(u->runs[k + 1]);
+            auto i = std::upper_bound(b, e, tp,
+                [](sys_seconds t, const abbrev_zone& a) {return t < a.begin;});
+            if (i != b && tp < i[-1].end)
+                return i[-1].zone;
+            // Past the index, ask the zones that used abbrev in its last year
+            if (i == e && tp >= last && e[-1].end > last - days {366} &&
+                e[-1].zone->get_info(tp).abbrev == abbrev)
+                return e[-1].zone;
+        }
+        return nullptr;
+    }
+
+    const time_zone*
+#if HAS_STRING_VIEW
+        locate_zone(std::string_view tz_name)
+#else
+        locate_zone(const std::string& tz_name)
+#endif
+    {
+        return get_tzdb().locate_zone(tz_name);
+    }
+
+    // Also reports a database that fails to load rather than throwing
+    tz_status
+#if HAS_STRING_VIEW
+        try_locate_zone(std::string_view tz_name, const time_zone*& zone) NOEXCEPT
+#else
+        try_locate_zone(const std::string& tz_name, const time_zone*& zone) NOEXCEPT
+#endif
+    {
+        zone = nullptr;
+        try {
+            return get_tzdb().try_locate_zone(tz_name, zone);
+        } catch (...) {
+            return tz_status::unavailable;
+        }
+    }
+
+#if USE_OS_TZDB
+
+    std::ostream&
+        operator<<(std::ostream& os, const tzdb& db) {
+        os << "Version: " << db.version << "\n\n";
+        for (const auto& x : db.zones)
+            os << x << '\n';
+#if !MISSING_LEAP_SECONDS
+        os << '\n';
+        for (const auto& x : db.leap_seconds)
+            os << x << '\n';
+#endif  // !MISSING_LEAP_SECONDS
+        return os;
+    }
 
 #else  // !USE_OS_TZDB
 
@@ -3209,11 +6530,19 @@ namespace date {
             "Designator\n"
             "--------------------------------------------"
             "--------------------------------------------\n");
+        // The rules are grouped by the index of their name, so list them by name
+        std::vector<const detail::Rule*> rules;
+        for (const auto& x : db.rules)
+            rules.push_back(&x);
+        std::stable_sort(rules.begin(), rules.end(),
+            [&db](const detail::Rule* x, const detail::Rule* y) {
+                return db.strings[x->name_id()] < db.strings[y->name_id()];
+            });
         int count = 0;
-        for (const auto& x : db.rules) {
+        for (auto x : rules) {
             if (count++ % 50 == 0)
                 os << title;
-            os << x << '\n';
+            os << detail::named_rule {*x, db.strings} << '\n';
         }
         os << '\n';
         title = std::string("---------------------------------------------------------"
@@ -3252,6 +6581,409 @@ namespace date {
         return os;
     }
 
+#endif  // !USE_OS_TZDB
+
+    static
+        std::size_t
+        heap_size(const std::string& s) {
+        auto p = reinterpret_cast<const char*>(&s);
+        std::less<const char*> less;
+        // Short strings are stored inside of the object
+        if (!less(s.data(), p) && less(s.data(), p + sizeof(s)))
+            return 0;
+        return s.capacity() + 1;
+    }
+
+    template <class T>
+    static
+        std::size_t
+        capacity_size(const std::vector<T>& v) {
+        return v.capacity() * sizeof(T);
+    }
+
+    tzdb_memory
+        memory_usage(const tzdb& db) {
+        tzdb_memory m;
+#if !USE_OS_TZDB
+        std::set<const detail::transition_table*> tables;
+#endif
+        m.zones = capacity_size(db.zones) + capacity_size(db.name_index) +
+            capacity_size(db.name_index_nocase);
+        for (auto const& z : db.zones) {
+            m.zones += heap_size(z.name_);
+            if (!z.initialized_.load(std::memory_order_acquire))
+                continue;
+#if USE_OS_TZDB
+            m.transitions += capacity_size(z.transitions_);
+            m.transitions += capacity_size(z.ttinfos_);
+            if (z.footer_ != nullptr)
+                m.transitions += sizeof(detail::posix_footer);
+            for (auto const& t : z.ttinfos_)
+                m.transitions += heap_size(t.abbrev);
+#else  // !USE_OS_TZDB
+            // Count a table shared by several zones once
+            if (z.table_ != nullptr && tables.insert(z.table_.get()).second)
+                m.transitions += sizeof(detail::transition_table) +
+                    capacity_size(z.table_->transition_storage) +
+                    capacity_size(z.table_->index_storage);
+            if (z.recurring_ != nullptr)
+                m.transitions += sizeof(detail::recurring_rules) +
+                    capacity_size(z.recurring_->rules);
+#endif  // !USE_OS_TZDB
+        }
+#if !USE_OS_TZDB
+        // The zonelets are only modified before the zone is initialized
+        for (auto const& z : db.zones)
+            m.zones += capacity_size(z.zonelets_) + capacity_size(z.zonelet_abbrevs_);
+        m.links = capacity_size(db.links);
+        for (auto const& l : db.links)
+            m.links += heap_size(l.name()) + heap_size(l.target());
+        m.rules = capacity_size(db.rules);
+        m.strings = capacity_size(db.strings) + capacity_size(db.abbrevs);
+        for (auto const& s : db.strings)
+            m.strings += heap_size(s);
+        for (auto const& s : db.abbrevs)
+            m.strings += heap_size(s);
+#endif  // !USE_OS_TZDB
+#if !MISSING_LEAP_SECONDS
+        m.leap_seconds = capacity_size(db.leap_seconds);
+#endif  // !MISSING_LEAP_SECONDS
+        m.strings += heap_size(db.version);
+        return m;
+    }
+
+    // Runs init on each zone not yet initialized, on up to threads threads
+    // including the caller.
+    static
+        void
+        prefetch_zones(std::vector<const time_zone*> zones, unsigned threads,
+            prefetch_result& r, void (*init)(const time_zone&)) {
+        if (threads == 0)
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, zones.size()));
+        std::atomic<std::size_t> next {0};
+        std::atomic<std::size_t> failed {0};
+        auto work = [&] {
+            for (auto i = next++; i < zones.size(); i = next++) {
+                try {
+                    init(*zones[i]);
+                } catch (const std::exception&) {
+                    ++failed;
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        if (threads > 1)
+            pool.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; ++i)
+            pool.emplace_back(work);
+        work();
+        for (auto& t : pool)
+            t.join();
+        r.failed += failed;
+        r.loaded += zones.size() - failed;
+    }
+
+    prefetch_result
+        prefetch_zones(const tzdb& db, const std::vector<std::string>& names, unsigned threads) {
+        auto start = std::chrono::steady_clock::now();
+        prefetch_result r;
+        std::vector<const time_zone*> zones;
+        zones.reserve(names.size());
+        for (auto const& name : names) {
+            auto z = db.find_zone(name).zone;
+            if (z == nullptr)
+                ++r.failed;
+            else if (!z->initialized_.load(std::memory_order_acquire))
+                zones.push_back(z);
+        }
+        // Names may repeat a zone, directly or through links
+        std::sort(zones.begin(), zones.end());
+        zones.erase(std::unique(zones.begin(), zones.end()), zones.end());
+        prefetch_zones(std::move(zones), threads, r, [](const time_zone& z) {z.init();});
+        r.elapsed = std::chrono::steady_clock::now() - start;
+        return r;
+    }
+
+    prefetch_result
+        prefetch_zones(const tzdb& db, unsigned threads) {
+        auto start = std::chrono::steady_clock::now();
+        prefetch_result r;
+        std::vector<const time_zone*> zones;
+        for (auto const& z : db.zones)
+            if (!z.initialized_.load(std::memory_order_acquire))
+                zones.push_back(&z);
+        prefetch_zones(std::move(zones), threads, r, [](const time_zone& z) {z.init();});
+        r.elapsed = std::chrono::steady_clock::now() - start;
+        return r;
+    }
+
+    std::ostream&
+        operator<<(std::ostream& os, const tzdb_memory& m) {
+        os << "zones:        " << m.zones << '\n';
+        os << "transitions:  " << m.transitions << '\n';
+        os << "links:        " << m.links << '\n';
+        os << "rules:        " << m.rules << '\n';
+        os << "leap seconds: " << m.leap_seconds << '\n';
+        os << "strings:      " << m.strings << '\n';
+        os << "total:        " << m.total() << '\n';
+        return os;
+    }
+
+#if !USE_OS_TZDB
+
+    // TZif export
+
+    namespace {
+
+        // Exported history runs to here, so that the footer can be checked
+        // against a few centuries of the rules it stands for.
+        CONSTDATA auto tzif_horizon = date::year {2400};
+
+        // Without a footer, transitions are written through this year, as
+        // zic does for "fat" files.
+        CONSTDATA auto tzif_fat_last_year = date::year {2037};
+
+        bool
+            same_type(const sys_info& x, const sys_info& y) {
+            using std::chrono::minutes;
+            return x.offset == y.offset && x.abbrev == y.abbrev &&
+                (x.save != minutes {0}) == (y.save != minutes {0});
+        }
+
+        void
+            put_be32(std::string& out, std::int32_t v) {
+            auto u = static_cast<std::uint32_t>(v);
+            for (int shift = 24; shift >= 0; shift -= 8)
+                out.push_back(static_cast<char>((u >> shift) & 0xFF));
+        }
+
+        void
+            put_be64(std::string& out, std::int64_t v) {
+            auto u = static_cast<std::uint64_t>(v);
+            for (int shift = 56; shift >= 0; shift -= 8)
+                out.push_back(static_cast<char>((u >> shift) & 0xFF));
+        }
+
+        // An abbreviation as a POSIX TZ name, quoted unless it is all letters
+        std::string
+            posix_name(const std::string& abbrev) {
+            bool alpha = abbrev.size() >= 3;
+            for (auto c : abbrev)
+                alpha = alpha && std::isalpha(static_cast<unsigned char>(c));
+            return alpha ? abbrev : '<' + abbrev + '>';
+        }
+
+        // [-]hh[:mm[:ss]]
+        std::string
+            posix_time(std::chrono::seconds t) {
+            using namespace std::chrono;
+            std::string r;
+            if (t < seconds {0}) {
+                r = '-';
+                t = -t;
+            }
+            auto h = duration_cast<hours>(t);
+            auto m = duration_cast<minutes>(t - h);
+            auto sec = t - h - m;
+            r += std::to_string(h.count());
+            if (m != minutes {0} || sec != seconds {0}) {
+                r += (m.count() < 10 ? ":0" : ":") + std::to_string(m.count());
+                if (sec != seconds {0})
+                    r += (sec.count() < 10 ? ":0" : ":") + std::to_string(sec.count());
+            }
+            return r;
+        }
+
+        // Ways to write a rule for a transition at local time lt:  as the nth
+        // weekday of the month and as a Julian day, each also counted from up
+        // to six days either side with the time moved to match (version 3
+        // allows -167 through 167 hours).  Which one holds in other years is
+        // found by checking them.
+        std::vector<std::string>
+            posix_rules(local_seconds lt) {
+            using namespace std::chrono;
+            std::vector<std::string> r;
+            // Nearest first, so the plainest form wins a tie
+            for (int i = 0; i <= 12; ++i) {
+                auto shift = i % 2 ? (i + 1) / 2 : -i / 2;
+                auto ld = floor<days>(lt) - days {shift};
+                auto tod = lt - ld;
+                auto time = tod == hours {2} ? std::string() : '/' + posix_time(tod);
+                year_month_day ymd {ld};
+                auto d = static_cast<unsigned>(ymd.day());
+                auto last = static_cast<unsigned>((ymd.year() / ymd.month() / date::last).day());
+                // A day in the last seven can also be the last such weekday
+                auto mwd = [&](unsigned w) {
+                    return 'M' + std::to_string(static_cast<unsigned>(ymd.month())) + '.' +
+                        std::to_string(w) + '.' +
+                        std::to_string(weekday {ld}.c_encoding()) + time;
+                };
+                r.push_back(mwd((d - 1) / 7 + 1));
+                if (d + 7 > last && d <= 28)
+                    r.push_back(mwd(5));
+                if (ymd.month() != date::February || ymd.day() != date::day {29}) {
+                    auto n = (ld - local_days(ymd.year() / date::January / 1)).count() + 1;
+                    if (ymd.year().is_leap() && ymd.month() > date::February)
+                        --n;
+                    r.push_back('J' + std::to_string(n) + time);
+                }
+            }
+            return r;
+        }
+
+        // Returns the first of the intervals v from which the rule f reproduces
+        // all the rest, or v.size() if it doesn't even match the last one.
+        std::size_t
+            footer_start(const Posix::time_zone& f, const std::vector<sys_info>& v) {
+            using std::chrono::seconds;
+            auto k = v.size() - 1;
+            auto fi = f.get_info(v[k].begin);
+            if (!same_type(fi, v[k]))
+                return v.size();
+            while (k > 0 && fi.begin == v[k].begin) {
+                auto fp = f.get_info(v[k].begin - seconds {1});
+                if (!same_type(fp, v[k - 1]) || fp.begin > v[k - 1].begin)
+                    break;
+                fi = fp;
+                --k;
+            }
+            return k;
+        }
+
+        // Finds a POSIX TZ string for the end of v and the interval it takes
+        // over from.  Gives an empty string and v.size() if there is none.  A
+        // rule has to hold for a century to be taken:  a wrong weekday rule
+        // breaks well within the 28 year cycle of the calendar.
+        std::pair<std::string, std::size_t>
+            make_footer(const std::vector<sys_info>& v) {
+            using namespace std::chrono;
+            auto const& last = v.back();
+            auto n = v.size();
+            const sys_seconds century = sys_days((tzif_horizon - years {100}) / min_day);
+            if (n < 3 || last.begin < century) {
+                // No transitions for a century:  a constant offset
+                auto tz = posix_name(last.abbrev) + posix_time(-last.offset);
+                return {tz, footer_start(Posix::time_zone {tz}, v)};
+            }
+            // The last two transitions are one into daylight saving time and
+            // one out of it
+            auto const& a = v[n - 2];
+            bool last_is_dst = last.save != minutes {0};
+            if ((a.save != minutes {0}) == last_is_dst)
+                return {std::string(), n};
+            auto const& dst = last_is_dst ? last : a;
+            auto const& std_ = last_is_dst ? a : last;
+            auto start = local_seconds {(dst.begin + v[last_is_dst ? n - 2 : n - 3].offset)
+                .time_since_epoch()};
+            auto end = local_seconds {(std_.begin + dst.offset).time_since_epoch()};
+            auto head = posix_name(std_.abbrev) + posix_time(-std_.offset) +
+                posix_name(dst.abbrev);
+            if (dst.offset - std_.offset != hours {1})
+                head += posix_time(-dst.offset);
+            std::pair<std::string, std::size_t> best {std::string(), n};
+            for (auto const& sr : posix_rules(start)) {
+                for (auto const& er : posix_rules(end)) {
+                    auto tz = head + ',' + sr + ',' + er;
+                    try {
+                        auto k = footer_start(Posix::time_zone {tz}, v);
+                        if (k < best.second)
+                            best = {tz, k};
+                    } catch (const std::exception&) {
+                        // Not something Posix::time_zone reads
+                    }
+                }
+            }
+            if (best.second == n || v[best.second].begin >= century)
+                return {std::string(), n};
+            return best;
+        }
+
+    }  // unnamed namespace
+
+    void
+        write_tzif(std::ostream& os, const time_zone& z) {
+        using namespace std::chrono;
+        // The zone's history, with intervals of the same type merged
+        std::vector<sys_info> v;
+        auto t = sys_seconds(sys_days(min_year / min_day));
+        const sys_seconds horizon = sys_days(tzif_horizon / min_day);
+        while (t < horizon) {
+            auto i = z.get_info(t);
+            if (!v.empty() && same_type(v.back(), i))
+                v.back().end = i.end;
+            else
+                v.push_back(i);
+            if (i.end <= t)
+                break;
+            t = i.end;
+        }
+        auto footer = make_footer(v);
+        std::size_t count = footer.second;
+        if (count == v.size()) {
+            // No rule to hand over to:  write out the transitions instead
+            const sys_seconds fat_end = sys_days((tzif_fat_last_year + years {1}) / min_day);
+            count = 0;
+            while (count + 1 < v.size() && v[count + 1].begin < fat_end)
+                ++count;
+        }
+        // Types in order of first use, so that type 0 is the initial one
+        std::vector<const sys_info*> types;
+        std::vector<std::uint8_t> indices;
+        std::string chars;
+        std::vector<std::uint8_t> abbrev_index;
+        auto type_of = [&](const sys_info& x) {
+            for (std::size_t j = 0; j < types.size(); ++j)
+                if (same_type(*types[j], x))
+                    return static_cast<std::uint8_t>(j);
+            if (types.size() == 256)
+                throw std::runtime_error("write_tzif: too many local time types in " +
+                    z.name());
+            auto p = chars.find(x.abbrev + '\0');
+            if (p == std::string::npos) {
+                p = chars.size();
+                chars += x.abbrev;
+                chars += '\0';
+            }
+            types.push_back(&x);
+            abbrev_index.push_back(static_cast<std::uint8_t>(p));
+            return static_cast<std::uint8_t>(types.size() - 1);
+        };
+        type_of(v[0]);
+        for (std::size_t j = 1; j <= count; ++j)
+            indices.push_back(type_of(v[j]));
+
+        std::string out;
+        auto header = [&](std::int32_t timecnt, std::int32_t typecnt, std::int32_t charcnt) {
+            out += "TZif3";
+            out.append(15, '\0');
+            put_be32(out, 0);  // isutcnt
+            put_be32(out, 0);  // isstdcnt
+            put_be32(out, 0);  // leapcnt
+            put_be32(out, timecnt);
+            put_be32(out, typecnt);
+            put_be32(out, charcnt);
+        };
+        // Version 2+ readers skip the version 1 block, so it gets one type and
+        // no transitions, as zic writes for "slim" files.
+        header(0, 1, 1);
+        put_be32(out, 0);
+        out.append(3, '\0');
+        header(static_cast<std::int32_t>(count), static_cast<std::int32_t>(types.size()),
+            static_cast<std::int32_t>(chars.size()));
+        for (std::size_t j = 1; j <= count; ++j)
+            put_be64(out, v[j].begin.time_since_epoch().count());
+        out.append(indices.begin(), indices.end());
+        for (std::size_t j = 0; j < types.size(); ++j) {
+            put_be32(out, static_cast<std::int32_t>(types[j]->offset.count()));
+            out.push_back(types[j]->save != minutes {0} ? 1 : 0);
+            out.push_back(static_cast<char>(abbrev_index[j]));
+        }
+        out += chars;
+        out += '\n' + footer.first + '\n';
+        os.write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+
 #endif  // !USE_OS_TZDB
 
     // -----------------------